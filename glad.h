@@ -1,9 +1,19 @@
 #ifndef GLAD_H
 #define GLAD_H
 
+/* pread, pwrite, ftruncate, madvise and MAP_ANONYMOUS are POSIX or BSD,
+ * not ISO C, so -std=c99 and later hide them unless a feature-test macro
+ * asks for them. This only works if glad.h comes before the first system 
+ * header; otherwise define _DEFAULT_SOURCE on the command line. */
+#if !defined(_DEFAULT_SOURCE) && !defined(_GNU_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
 #include <stddef.h>
 #include <unistd.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <assert.h>
@@ -11,390 +21,4642 @@
 #include <stdalign.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
 
 #define NDEBUG
 
+/* Every function is static inline, so the header can be included from any
+ * number of translation units, and calls with constant sizes and alignments
+ * fold down to a compare and a pointer bump. The slow paths stay out of line
+ * to keep the inlined fast paths small. */
+#ifndef GLAD_DEF
+#define GLAD_DEF static inline
+#define GLAD_DEFAULT_DEF
+#endif
+/* the slow paths follow an overridden GLAD_DEF, which must not say inline
+ * then; define GLAD_NOINLINE too to pick their linkage separately. */
+#ifndef GLAD_NOINLINE
+#ifdef GLAD_DEFAULT_DEF
+#define GLAD_NOINLINE_DEF static
+#else
+#define GLAD_NOINLINE_DEF GLAD_DEF
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define GLAD_NOINLINE GLAD_NOINLINE_DEF __attribute__((noinline, unused))
+#else
+#define GLAD_NOINLINE GLAD_NOINLINE_DEF
+#endif
+#endif
+
+/* C++ has no restrict, but GCC, Clang and MSVC all spell it __restrict */
+#ifdef __cplusplus
+#define GLAD_RESTRICT __restrict
+#else
+#define GLAD_RESTRICT restrict
+#endif
+
+/* the concurrent arena needs pthreads and the GCC/Clang __atomic builtins.
+ * define GLAD_NO_THREADS to leave it out. */
+#if !defined(GLAD_THREADS) && !defined(GLAD_NO_THREADS) && (defined(__GNUC__) || defined(__clang__))
+#define GLAD_THREADS
+#endif
+#ifdef GLAD_THREADS
+#include <pthread.h>
+#endif
+
+/* glad_copy streams large copies past the cache with AVX2 or AVX-512, 
+ * picked at run time through the GCC/Clang target attribute and CPU 
+ * detection builtins. define GLAD_NO_STREAM to always use memcpy. */
+#if !defined(GLAD_NO_STREAM) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GLAD_STREAM
+#define GLAD_TARGET(X) __attribute__((target(X)))
+#include <immintrin.h>
+#endif
+
+/* define GLAD_STATS to have every arena keep allocation counters, see
+ * arena_get_stats. GLAD_STAT(X) expands to X only in such builds. */
+#ifdef GLAD_STATS
+#define GLAD_STAT(X) X
+#else
+#define GLAD_STAT(X)
+#endif
+
+/* define GLAD_GUARD for the guarded debug backend: every chunk is followed 
+ * by a PROT_NONE page, arena_config's ac_guard gives each allocation pages 
+ * of its own, and memory given back by arena_reset and arena_rewind is 
+ * poisoned. Under AddressSanitizer poisoning uses its manual interface,
+ * otherwise the memory is filled with GLAD_POISON_BYTE. */
+#ifdef GLAD_GUARD
+#if defined(__SANITIZE_ADDRESS__)
+#define GLAD_ASAN
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define GLAD_ASAN
+#endif
+#endif
+#ifndef GLAD_POISON_BYTE
+#define GLAD_POISON_BYTE 0xA5
+#endif
+#endif
+
+#ifdef GLAD_ASAN
+#include <sanitizer/asan_interface.h>
+#define GLAD_POISON(p, n) ASAN_POISON_MEMORY_REGION(p, n)
+#define GLAD_UNPOISON(p, n) ASAN_UNPOISON_MEMORY_REGION(p, n)
+#elif defined(GLAD_GUARD)
+#define GLAD_POISON(p, n) memset(p, GLAD_POISON_BYTE, n)
+#define GLAD_UNPOISON(p, n) ((void)0)
+#else
+#define GLAD_POISON(p, n) ((void)0)
+#define GLAD_UNPOISON(p, n) ((void)0)
+#endif
+
  /* 
   * goals: 
-  * 	- memory profiling 
-  * 	- debugging, pass in info via a macro 
   * 	- support for new backends? WASM?
   */ 
 
+/* size of the first chunk of an arena. small enough that short-lived
+ * arenas only map a handful of pages */
+#define DEFAULT_CHUNK_SIZE (64L*1024L)
 /* appropriately large. in this case, a full PMD (the layer of the 
  * page table hierarchy above a PTE) work of pages on x86 */
-#define DEFAULT_CHUNK_SIZE (4096L*1024L*1024L)/(sizeof(char))
+#define DEFAULT_MAX_CHUNK_SIZE (4096L*1024L*1024L)
+/* each new chunk is this many times the size of the previous one */
+#define DEFAULT_GROWTH 2
+/* address space a RESERVE arena reserves per chunk, and the step it commits in */
+#define DEFAULT_RESERVE_SIZE (64L*1024L*1024L*1024L)
+#define DEFAULT_COMMIT_SIZE (64L*1024L)
+/* mapped bytes a chunk_cache holds on to unless told otherwise */
+#define DEFAULT_CACHE_SIZE (64L*1024L*1024L)
+/* arena_pool size classes are the powers of two from 1 << POOL_MIN_SHIFT to
+ * 1 << (POOL_MIN_SHIFT + POOL_CLASSES - 1) bytes, 16 B to 4 KiB */
+#define POOL_MIN_SHIFT 4
+#define POOL_CLASSES 9
+/* carena claims space in multiples of this, so smaller alignments cost no padding */
+#define CARENA_GRAIN 16
+/* bytes a tarena takes from its carena at once */
+#define DEFAULT_SLAB_SIZE (64L*1024L)
+/* slabs are cache-line aligned so that threads never share a line */
+#define SLAB_ALIGN 64
+/* DISCARD arenas hand chunks with at least this many used bytes back to the 
+ * kernel on arena_clear, below it a memset is cheaper than the page faults */
+#define DEFAULT_DISCARD_SIZE (256L*1024L)
+/* arena_read_fd reads pipes and sockets into a region this large at first,
+ * doubling it whenever it fills up */
+#define DEFAULT_READ_SIZE (64L*1024L)
+/* glad_copy uses plain memcpy below this many bytes, where the copy likely 
+ * fits in cache and will be read back soon */
+#ifndef GLAD_STREAM_SIZE
+#define GLAD_STREAM_SIZE (1L*1024L*1024L)
+#endif
+/* how far ahead of the copy glad_copy prefetches the source */
+#define GLAD_PREFETCH_DISTANCE 1024
+/* the _parallel variants split copies into tasks of at most this many bytes,
+ * so a single huge chunk still spreads over every thread */
+#define DEFAULT_COPY_SLICE (16L*1024L*1024L)
+/* arena_crop_and_coalesce keeps data aligned to this, enough for any 
+ * fundamental type */
+#define DEFAULT_COMPACT_ALIGN 16
+/* most threads glad_run starts for an executor without ex_run */
+#define GLAD_MAX_THREADS 256
 #define CHUNK_ALLOC_SIZE(X) (sizeof(chunk) + (sizeof(char) * X))
 
 #define ROUND_UP(val, size) ((val + size - 1) & -size)
 #define ZEROMEM 0x1 	/* If this flag is set for a function that accepts it, the corresponding memory will be zeroed */
 #define SOFTFAIL 0x10	/* If this flag is set, the function will return an error value instead of assert(0). */
+#define FIRSTFIT 0x100	/* If this flag is set, arena_alloc searches all chunks from ar_head for the first one that fits. */
+#define HUGEPAGE 0x1000	/* If this flag is set, new chunks are huge-page aligned and madvise'd for transparent huge pages. */
+#define HUGETLB 0x10000	/* If this flag is set, new chunks are backed by hugetlb pages, falling back to HUGEPAGE. */
+#define RESERVE 0x100000	/* If this flag is set, new chunks reserve address space and commit pages as they are used. */
+#define DISCARD 0x1000000	/* If this flag is set, arena_clear gets zero pages from the kernel instead of writing them. */
+#define SNAPSHOT 0x10000000	/* If this flag is set, new chunks are memfd-backed and arena_copy maps them copy-on-write. */
+
+/* huge page size used by HUGEPAGE and HUGETLB, 2 MiB by default. 
+ * define GLAD_HUGE_PAGE_SHIFT to 30 for 1 GiB pages. */
+#ifndef GLAD_HUGE_PAGE_SHIFT
+#define GLAD_HUGE_PAGE_SHIFT 21
+#endif
+#define GLAD_HUGE_PAGE_SIZE (1L << GLAD_HUGE_PAGE_SHIFT)
+
+/* internal ch_flags bits */
+#define CHUNK_HUGETLB 0x1	/* backed by hugetlb pages */
+#define CHUNK_THP 0x2		/* huge-page aligned and madvise'd for transparent huge pages */
+#define CHUNK_RESERVE 0x4	/* pages past ch_commit are reserved but PROT_NONE */
+#define CHUNK_GUARD 0x8		/* the page after the mapping is a PROT_NONE guard, see GLAD_GUARD */
+#define CHUNK_MEMFD 0x10	/* a MAP_SHARED mapping of the memfd in ch_fd */
+#define CHUNK_FROZEN 0x20	/* a MAP_PRIVATE mapping of a memfd that a snapshot shares */
+#define CHUNK_FILE 0x40		/* the image of a file opened by arena_file_open, fd in ch_fd */
+#define CHUNK_MAPPED 0x80	/* a MAP_PRIVATE file mapping from arena_map_fd, the header ends the page before it */
+#define CHUNK_BUFFER 0x100	/* one of the registered buffers of a cache_init_buffers cache */
+
+/* arena_file_open images start with an arena_image header, and the chunk
+ * follows at GLAD_IMAGE_OFFSET, a multiple of every common page size */
+#define GLAD_IMAGE_MAGIC 0x474d4944414c47ULL	/* "GLADIMG" */
+#define GLAD_IMAGE_VERSION 1
+#define GLAD_IMAGE_OFFSET (64L*1024L)
+
+/* SNAPSHOT chunks need memfd_create, called through syscall(2) since glibc 
+ * only declares it for _GNU_SOURCE. Elsewhere they are ordinary chunks. */
+#if defined(__linux__) && (defined(_DEFAULT_SOURCE) || defined(_GNU_SOURCE))
+#include <sys/syscall.h>
+#ifdef SYS_memfd_create
+#define GLAD_MEMFD
+#endif
+/* ac_node binds chunks with mbind(2) and carena_nodes finds the node with
+ * getcpu(2), both through syscall(2) so that libnuma isn't needed */
+#if defined(SYS_mbind) && defined(SYS_getcpu)
+#define GLAD_NUMA
+#endif
+#endif
+
+/* nodes glad_mbind can bind to, and the mbind(2) constants from numaif.h */
+#define GLAD_MAX_NODES 1024
+#define GLAD_MPOL_PREFERRED 1
+#define GLAD_MPOL_MF_MOVE (1 << 1)
+
+/* Anonymous mappings save the open/close of /dev/zero on every chunk.
+ * Define GLAD_DEVZERO to force the /dev/zero backend. */
+#if !defined(GLAD_DEVZERO) && !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#if !defined(GLAD_DEVZERO) && !defined(MAP_ANONYMOUS)
+#define GLAD_DEVZERO
+#endif
 
 #define glad_new(...) glad_new_impl(__VA_ARGS__, glad_new4, glad_new3, glad_new2)(__VA_ARGS__)
 #define glad_new_impl(_1, _2, _3, _4, FUNC, ...) FUNC
+#define glad_push(...) glad_push_impl(__VA_ARGS__, glad_push5, glad_push4)(__VA_ARGS__)
+#define glad_push_impl(_1, _2, _3, _4, _5, FUNC, ...) FUNC
+/* glad_new_n(a, t, n, out[, f]) allocates n contiguous t's and writes the
+ * address of each to the void* array out, which may be 0 */
+#define glad_new_n(...) glad_new_n_impl(__VA_ARGS__, glad_new_n5, glad_new_n4)(__VA_ARGS__)
+#define glad_new_n_impl(_1, _2, _3, _4, _5, FUNC, ...) FUNC
+/* glad_new_fin(a, t, fn[, f]): a t whose finalizer fn runs with the arena's, see arena_on_free */
+#define glad_new_fin(...) glad_new_fin_impl(__VA_ARGS__, glad_new_fin4, glad_new_fin3)(__VA_ARGS__)
+#define glad_new_fin_impl(_1, _2, _3, _4, FUNC, ...) FUNC
+
+#ifndef GLAD_DEBUG
 #define glad_new2(a, t)          (t *)arena_alloc(a, sizeof(t), alignof(t), ZEROMEM)
 #define glad_new3(a, t, n)       (t *)arena_alloc(a, n * sizeof(t), alignof(t), ZEROMEM)
 #define glad_new4(a, t, n, f)    (t *)arena_alloc(a, n * sizeof(t), alignof(t), f)
 
-#define glad_push(...) glad_push_impl(__VA_ARGS__, glad_push5, glad_push4)(__VA_ARGS__)
-#define glad_push_impl(_1, _2, _3, _4, _5, FUNC, ...) FUNC
 #define glad_push4(a, t, d, n)    (t *)arena_push(a, d, n * sizeof(t), alignof(t), ZEROMEM)
 #define glad_push5(a, t, d, n, f) (t *)arena_push(a, d, n * sizeof(t), alignof(t), f)
 
+#define glad_new_n4(a, t, n, o)    (t *)arena_alloc_array(a, sizeof(t), alignof(t), n, o, ZEROMEM)
+#define glad_new_n5(a, t, n, o, f) (t *)arena_alloc_array(a, sizeof(t), alignof(t), n, o, f)
+#define glad_new_fin3(a, t, fn)    (t *)arena_alloc_finalized(a, sizeof(t), alignof(t), fn, ZEROMEM)
+#define glad_new_fin4(a, t, fn, f) (t *)arena_alloc_finalized(a, sizeof(t), alignof(t), fn, f)
+
+#define glad_tag(a, tag) ((void)0)
+#else
+#define glad_new2(a, t)          (t *)arena_alloc_site(a, sizeof(t), alignof(t), ZEROMEM, __FILE__, __LINE__, #t)
+#define glad_new3(a, t, n)       (t *)arena_alloc_site(a, n * sizeof(t), alignof(t), ZEROMEM, __FILE__, __LINE__, #t)
+#define glad_new4(a, t, n, f)    (t *)arena_alloc_site(a, n * sizeof(t), alignof(t), f, __FILE__, __LINE__, #t)
+
+#define glad_push4(a, t, d, n)    (t *)arena_push_site(a, d, n * sizeof(t), alignof(t), ZEROMEM, __FILE__, __LINE__, #t)
+#define glad_push5(a, t, d, n, f) (t *)arena_push_site(a, d, n * sizeof(t), alignof(t), f, __FILE__, __LINE__, #t)
+
+#define glad_new_n4(a, t, n, o)    (t *)arena_alloc_array_site(a, sizeof(t), alignof(t), n, o, ZEROMEM, __FILE__, __LINE__, #t)
+#define glad_new_n5(a, t, n, o, f) (t *)arena_alloc_array_site(a, sizeof(t), alignof(t), n, o, f, __FILE__, __LINE__, #t)
+#define glad_new_fin3(a, t, fn)    (t *)arena_alloc_finalized_site(a, sizeof(t), alignof(t), fn, ZEROMEM, __FILE__, __LINE__, #t)
+#define glad_new_fin4(a, t, fn, f) (t *)arena_alloc_finalized_site(a, sizeof(t), alignof(t), fn, f, __FILE__, __LINE__, #t)
+
+/* allocations made through the macros after this are reported under tag */
+#define glad_tag(a, tag) arena_set_tag(a, tag)
+#endif
+
+#define glad_pool_new(...) glad_pool_new_impl(__VA_ARGS__, glad_pool_new3, glad_pool_new2)(__VA_ARGS__)
+#define glad_pool_new_impl(_1, _2, _3, FUNC, ...) FUNC
+#define glad_pool_new2(p, t)      (t *)pool_alloc(p, sizeof(t), alignof(t), ZEROMEM)
+#define glad_pool_new3(p, t, f)   (t *)pool_alloc(p, sizeof(t), alignof(t), f)
+#define glad_pool_delete(p, t, x) pool_free(p, x, sizeof(t), alignof(t))
+
+#define glad_vec_init(v, a, t)    vec_init(v, a, sizeof(t), alignof(t))
+#define glad_vec_push(v, t)       (t *)vec_extend(v, 1, ZEROMEM)
+#define glad_vec_at(v, t, i)      (((t *)(v)->av_data)[i])
+#define glad_map_init(m, a, t)    map_init(m, a, sizeof(t), alignof(t))
+#define glad_map_put(m, t, k)     (t *)map_put(m, k)
+#define glad_map_get(m, t, k)     (t *)map_get(m, k)
+#define glad_rel_ptr(r, t)        (t *)glad_rel_get(r)
+
+#define glad_realloc(...) glad_realloc_impl(__VA_ARGS__, glad_realloc6, glad_realloc5)(__VA_ARGS__)
+#define glad_realloc_impl(_1, _2, _3, _4, _5, _6, FUNC, ...) FUNC
+#define glad_realloc5(a, t, p, o, n)    (t *)arena_realloc(a, p, (o) * sizeof(t), (n) * sizeof(t), alignof(t), ZEROMEM)
+#define glad_realloc6(a, t, p, o, n, f) (t *)arena_realloc(a, p, (o) * sizeof(t), (n) * sizeof(t), alignof(t), f)
+
 
 typedef struct chunk chunk;
 struct chunk {
 	chunk* ch_next;
 	ptrdiff_t ch_size;
 	ptrdiff_t ch_offset;
-	char ch_data[];
+	ptrdiff_t ch_dirty;	/* bytes past max(ch_dirty, ch_offset) are known to be zero */
+	ptrdiff_t ch_commit;	/* usable bytes of ch_data, less than ch_size for RESERVE chunks */
+	int ch_flags;		/* CHUNK_* bits describing the mapping */
+	int ch_fd;		/* the memfd of CHUNK_MEMFD chunks, the file of CHUNK_FILE ones */
+	alignas(16) char ch_data[];	/* keeps the data 16-byte aligned whatever the header holds */
+};
+
+/* Idle chunks kept mapped for reuse, so that freeing an arena and building
+ * a new one does not go through munmap and mmap again. Zeroed fields select
+ * the defaults. Caches are owned by the caller and are not thread-safe; 
+ * share one between arenas by pointing their arena_config at it. */
+typedef struct chunk_cache chunk_cache;
+struct chunk_cache {
+	chunk* cc_head;		/* idle chunks, most recently cached first */
+	ptrdiff_t cc_bytes;	/* mapped bytes currently held */
+	ptrdiff_t cc_max_bytes;	/* high-water mark, chunks past it are unmapped */
+	int cc_madvise;		/* madvise(MADV_FREE) chunks while they sit idle */
+
+	/* registered buffers, see cache_init_buffers. 0 for ordinary caches */
+	char* cc_buffers;	/* the mapping every buffer lies in */
+	ptrdiff_t cc_stride;	/* mapped bytes per buffer, chunk header included */
+	int cc_count;		/* number of buffers */
+	struct iovec* cc_iovecs;	/* the data of each buffer, calloc'd */
+};
+
+#ifdef GLAD_STATS
+/* Counters kept by an arena, see arena_get_stats. */
+typedef struct arena_stats arena_stats;
+struct arena_stats {
+	ptrdiff_t st_allocs;	/* successful arena_alloc calls */
+	ptrdiff_t st_failed;	/* arena_alloc calls that returned 0 */
+	ptrdiff_t st_requested;	/* bytes asked for, net of in-place resizes */
+	ptrdiff_t st_padding;	/* bytes lost to alignment on top of st_requested */
+	ptrdiff_t st_used;	/* bytes handed out and not yet given back, from arena_get_size */
+	ptrdiff_t st_peak;	/* highest st_used seen */
+	ptrdiff_t st_chunks;	/* chunks owned by the arena */
+	ptrdiff_t st_mapped;	/* bytes mapped for them, from arena_get_mapped */
+};
+#endif
+
+#ifdef GLAD_DEBUG
+/* Allocations made from one call site, see arena_report. */
+typedef struct arena_site arena_site;
+struct arena_site {
+	const char* as_file;
+	int as_line;
+	const char* as_type;	/* type name passed to the macro */
+	const char* as_tag;	/* the arena's tag at the time, see glad_tag */
+	ptrdiff_t as_count;	/* allocations made */
+	ptrdiff_t as_bytes;	/* bytes requested by them */
+};
+#endif
+
+/* A cleanup registered with arena_on_free, stored in the arena it belongs to. */
+typedef struct arena_finalizer arena_finalizer;
+struct arena_finalizer {
+	arena_finalizer* fz_next;	/* registered before this one */
+	void (*fz_fn)(void*);
+	void* fz_object;
+};
+
+/* The data of one chunk as an address range, see arena_contains. */
+typedef struct arena_range arena_range;
+struct arena_range {
+	uintptr_t rg_start;
+	uintptr_t rg_end;	/* one past the last byte */
 };
 
 typedef struct arena arena; 
 struct arena {
 	chunk* ar_head;
 	chunk* ar_tail;
+	chunk* ar_curr;	/* chunk the bump pointer points into; its ch_offset is synced lazily */
+	char* ar_ptr;	/* next free byte in ar_curr */
+	char* ar_end;	/* one past the last usable byte in ar_curr */
+	char* ar_zero;	/* ar_curr's ch_dirty as a pointer, for ZEROMEM */
+
+	/* growth policy, 0 selects the default */
+	ptrdiff_t ar_min_chunk;		/* mapped size of the first chunk */
+	ptrdiff_t ar_max_chunk;		/* chunks stop growing at this size */
+	int ar_growth;			/* factor applied to each new chunk */
+	ptrdiff_t ar_next_chunk;	/* size of the next chunk to map */
+
+	chunk_cache* ar_cache;	/* where chunks come from and go back to, if set */
+	int ar_flags;		/* flags added to every chunk allocation, e.g. HUGEPAGE */
+	ptrdiff_t ar_reserve;	/* chunk size of RESERVE arenas, 0 selects DEFAULT_RESERVE_SIZE */
+	arena_finalizer* ar_finalizers;	/* most recently registered first, see arena_on_free */
+
+	/* running totals, so that arena_get_size and arena_get_mapped are O(1) */
+	ptrdiff_t ar_used;	/* ch_offset summed over every chunk but ar_curr */
+	ptrdiff_t ar_mapped;	/* CHUNK_ALLOC_SIZE summed over every chunk */
+	/* data ranges of the chunks sorted by address, malloc'd, see arena_contains */
+	arena_range* ar_ranges;
+	ptrdiff_t ar_range_count;	/* -1 when the index could not be allocated */
+	ptrdiff_t ar_range_cap;
+#ifdef GLAD_NUMA
+	int ar_node;		/* 1 + the NUMA node new chunks are bound to, 0 for none */
+#endif
+#ifdef GLAD_STATS
+	arena_stats ar_stats;
+#endif
+#ifdef GLAD_GUARD
+	int ar_guard;		/* one allocation per chunk, flush against its guard page */
+#endif
+#ifdef GLAD_DEBUG
+	/* call sites seen by the macros, malloc'd and freed by arena_free */
+	arena_site* ar_sites;
+	ptrdiff_t ar_site_count;
+	ptrdiff_t ar_site_cap;
+	const char* ar_tag;
+#endif
+};
+
+/* A position in an arena recorded by arena_mark, see arena_rewind. */
+typedef struct arena_savepoint arena_savepoint;
+struct arena_savepoint {
+	chunk* sp_curr;		/* current chunk at the mark, 0 for an empty arena */
+	ptrdiff_t sp_offset;	/* its offset at the mark */
+	chunk* sp_tail;		/* last chunk at the mark, later ones are released on rewind */
+	arena_finalizer* sp_finalizers;	/* newest finalizer at the mark, later ones run on rewind */
+};
+
+/* One region of an arena_alloc_batch call. */
+typedef struct arena_request arena_request;
+struct arena_request {
+	ptrdiff_t rq_size;
+	ptrdiff_t rq_alignment;	/* a power of 2 */
+};
+
+/* Where one chunk's bytes went in arena_compact. */
+typedef struct arena_reloc arena_reloc;
+struct arena_reloc {
+	uintptr_t rl_old;	/* old address of the chunk's data */
+	ptrdiff_t rl_size;	/* bytes that moved */
+	ptrdiff_t rl_delta;	/* new address minus old address */
+};
+
+/* The relocation table filled by arena_compact, sorted by rl_old. */
+typedef struct arena_relocs arena_relocs;
+struct arena_relocs {
+	arena_reloc* rs_entries;	/* malloc'd, freed by arena_relocs_free */
+	ptrdiff_t rs_count;
+};
+
+/* How the _parallel variants run their tasks. ex_run, if set, must call
+ * task(arg, i) once for every i in [0, count), in any order and on any 
+ * threads, and return only once all of them are done. Without it glad_run
+ * starts ex_threads threads itself, 0 for one per online CPU. */
+typedef struct glad_executor glad_executor;
+struct glad_executor {
+	void (*ex_run)(void* ex_data, void (*task)(void*, ptrdiff_t), void* arg, ptrdiff_t count);
+	void* ex_data;
+	int ex_threads;
+};
+
+/* One slice of a copy queued by copy_batch_add. */
+typedef struct glad_copy_job glad_copy_job;
+struct glad_copy_job {
+	char* cj_dst;
+	const char* cj_src;
+	ptrdiff_t cj_size;
+};
+
+/* Copies collected up front so that glad_run can spread them over threads. */
+typedef struct glad_copy_batch glad_copy_batch;
+struct glad_copy_batch {
+	glad_copy_job* cb_jobs;	/* realloc'd, freed by copy_batch_run */
+	ptrdiff_t cb_count;
+	ptrdiff_t cb_cap;
+};
+
+/* Runs the copies queued in a batch. The _parallel functions pass
+ * copy_batch_run, the serial ones none, so that only the former pull in 
+ * glad_run and with it pthreads. */
+typedef void (*glad_batch_run)(glad_copy_batch* batch, const glad_executor* executor);
+
+/* The header at the start of a file opened by arena_file_open. Offsets are
+ * relative to the chunk's ch_data, so the image works at any address. */
+typedef struct arena_image arena_image;
+struct arena_image {
+	uint64_t im_magic;	/* GLAD_IMAGE_MAGIC */
+	uint32_t im_version;	/* GLAD_IMAGE_VERSION */
+	uint32_t im_header;	/* sizeof(chunk) of the writer, where ch_data starts */
+	int64_t im_offset;	/* file offset of the chunk, GLAD_IMAGE_OFFSET */
+	int64_t im_used;	/* ch_offset when the image was last synced */
+	int64_t im_root;	/* offset of the root object, -1 for none */
+};
+
+/* A pointer stored as the distance from its own address, so that it stays
+ * valid wherever the arena holding it is mapped. 0 is the null pointer. */
+typedef ptrdiff_t glad_rel;
+
+/* Options for arena_init. Zeroed fields select the defaults. */
+typedef struct arena_config arena_config;
+struct arena_config {
+	ptrdiff_t ac_min_chunk;
+	ptrdiff_t ac_max_chunk;
+	int ac_growth;
+	chunk_cache* ac_cache;
+	int ac_flags;
+	ptrdiff_t ac_reserve;
+	int ac_guard;	/* GLAD_GUARD builds: end every allocation against a guard page */
+	int ac_node;	/* GLAD_NUMA builds: 1 + the NUMA node to bind new chunks to, 0 for none. 
+			 * SNAPSHOT copies share the source's pages and keep their placement. */
+};
+
+/* Free lists of fixed-size nodes carved out of an arena, for structures that
+ * delete and reinsert nodes. A freed node goes on the list of its size class
+ * and is handed out again before the arena is asked for more. The memory 
+ * still belongs to the arena and is released with it. */
+typedef struct arena_pool arena_pool;
+struct arena_pool {
+	arena* ap_arena;
+	void* ap_free[POOL_CLASSES];	/* free nodes of each class, linked through their first word */
+};
+
+/* A growable array in an arena. Growing goes through arena_realloc, so it
+ * happens in place while the array is the arena's last allocation. Zeroed 
+ * fields other than av_arena, av_elem and av_align describe an empty array. */
+typedef struct arena_vec arena_vec;
+struct arena_vec {
+	arena* av_arena;
+	char* av_data;
+	ptrdiff_t av_len;	/* elements in use */
+	ptrdiff_t av_cap;	/* elements allocated */
+	ptrdiff_t av_elem;	/* size of an element */
+	ptrdiff_t av_align;	/* alignment of an element */
+};
+
+/* A string builder, an arena_vec of chars. See the str_ functions. */
+typedef arena_vec arena_str;
+
+/* An open-addressing hash map from uint64_t keys to fixed-size values in an
+ * arena. Keys and values live in separate arrays, so probing only touches 
+ * keys. Key 0 marks an empty slot and is kept apart in the last value slot.
+ * Growing leaves the old arrays in the arena. */
+typedef struct arena_map arena_map;
+struct arena_map {
+	arena* am_arena;
+	uint64_t* am_keys;	/* am_cap slots, 0 when empty */
+	char* am_vals;		/* am_cap + 1 values, the last one for key 0 */
+	ptrdiff_t am_cap;	/* slots, a power of two or 0 */
+	ptrdiff_t am_len;	/* keys stored, key 0 included */
+	ptrdiff_t am_elem;	/* size of a value */
+	ptrdiff_t am_align;	/* alignment of a value */
+	int am_has_zero;	/* key 0 is stored */
+};
+
+#ifdef GLAD_THREADS
+/* An arena that can be allocated from by many threads at once. Allocation
+ * claims space with an atomic fetch-add on the current chunk's ch_offset;
+ * only installing a new chunk takes ca_lock. Everything but carena_alloc 
+ * and carena_get_size needs the arena to be quiescent. */
+typedef struct carena carena;
+struct carena {
+	arena ca_arena;		/* chunk list, growth policy and cache, guarded by ca_lock; 
+				 * its arena_get_size is meaningless, use carena_get_size */
+	chunk* ca_curr;		/* chunk being bump-allocated, accessed atomically */
+	pthread_mutex_t ca_lock;
+	unsigned ca_epoch;	/* bumped by carena_reset, so tarenas drop their slabs */
+};
+
+/* One carena per NUMA node, each binding its chunks to its node. Threads
+ * pick theirs with carena_nodes_local. */
+typedef struct carena_nodes carena_nodes;
+struct carena_nodes {
+	carena* cn_arenas;	/* cn_count of them, calloc'd */
+	int cn_count;
 };
 
+/* A per-thread front end to a carena. It takes ta_slab bytes from the parent
+ * at a time and bump-allocates from them without atomics, so threads do not 
+ * fight over the parent's ch_offset. Meant to be declared _Thread_local; the
+ * memory belongs to the parent and is released by carena_free. */
+typedef struct tarena tarena;
+struct tarena {
+	carena* ta_parent;
+	ptrdiff_t ta_slab;	/* slab size, 0 selects DEFAULT_SLAB_SIZE */
+	char* ta_ptr;		/* next free byte in the slab */
+	char* ta_end;		/* one past the last byte of the slab */
+	char* ta_zero;		/* bytes from here to ta_end are known to be zero */
+	unsigned ta_epoch;	/* parent's ca_epoch when the slab was taken */
+};
+#endif
+
 /** 
- * @brief 	Allocates a single chunk with at least the specified size.
- * 
- * @details
- * 		Uses mmap to allocate a chunk of memory with at least enough room
- *		for the chunk struct itself and size*sizeof(char) bytes.
+ * @brief	Initializes an empty arena with the given options.
  *
- * @param size 	The minimum number of bytes to allocate in the chunk.
- * @param flags Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory.
+ * @details
+ * 		A zeroed arena behaves as if it was initialized with a zeroed 
+ * 		config, so calling this is only needed to change the defaults. 
  *
- * @return 	A pointer to the allocated chunk. If mmap fails for any reason, this
- * 		function returns 0.
+ * @param arena 	The arena to initialize. Must not own any chunks.
+ * @param config 	The options to apply, or 0 for the defaults.
  */
-chunk* alloc_chunk(ptrdiff_t size, int flags)
+GLAD_DEF void arena_init(arena* arena, const arena_config* config)
 {
-	if (!size)
-		return 0;
+	if (!arena)
+		return;
 
-	ptrdiff_t allocation_size = CHUNK_ALLOC_SIZE(size);
-	
-	if (allocation_size < size)
-		return 0;
+	memset(arena, 0, sizeof *arena);
+	if (!config)
+		return;
+
+	arena->ar_min_chunk = config->ac_min_chunk > 0 ? config->ac_min_chunk : 0;
+	arena->ar_max_chunk = config->ac_max_chunk > 0 ? config->ac_max_chunk : 0;
+	arena->ar_growth = config->ac_growth > 0 ? config->ac_growth : 0;
+	arena->ar_cache = config->ac_cache;
+	arena->ar_flags = config->ac_flags;
+#ifdef GLAD_GUARD
+	arena->ar_guard = config->ac_guard;
+#endif
+	arena->ar_reserve = config->ac_reserve > 0 ? config->ac_reserve : 0;
+#ifdef GLAD_NUMA
+	arena->ar_node = config->ac_node > 0 && config->ac_node <= GLAD_MAX_NODES ? config->ac_node : 0;
+#endif
+}
 
+/** 
+ * @brief 	Maps length bytes of zero-filled, private memory.
+ *
+ * @param length 	The size of the mapping.
+ * @param prot 		The protection of the mapping, PROT_NONE to only reserve it.
+ * @param map_flags 	Extra mmap flags, e.g. MAP_HUGETLB.
+ *
+ * @return 	The mapping, or MAP_FAILED.
+ */
+GLAD_DEF void* glad_mmap(ptrdiff_t length, int prot, int map_flags)
+{
+#ifndef GLAD_DEVZERO
+	return mmap(0, length, prot, MAP_PRIVATE | MAP_ANONYMOUS | map_flags, -1, 0);
+#else
 	/* Anonymous map, compatible with systems that lack MAP_ANONYMOUS */	
 	int fd = open("/dev/zero", O_RDWR);
 	
 	if (fd == -1)
-		return 0;
+		return MAP_FAILED;
 
-	chunk* ret_chunk = (chunk*)mmap(0,
-			allocation_size, 
-			PROT_READ | PROT_WRITE,
-			MAP_PRIVATE,
-			fd, 0);
+	void* mapping = mmap(0, length, prot, MAP_PRIVATE | map_flags, fd, 0);
 	close(fd);
-	if (ret_chunk == MAP_FAILED) {
-		if (flags & SOFTFAIL) {
-			return 0;	
-		}
-		assert(0);
-	}
-
-	if (flags & ZEROMEM) {
-		memset(ret_chunk, 0, allocation_size);
-	}
-
-	ret_chunk->ch_next = 0;
-	ret_chunk->ch_size = size;
-	ret_chunk->ch_offset = 0;
-	return ret_chunk;
+	return mapping;
+#endif
 }
 
 /** 
- * @brief 	Frees the chunk at the provided reference.
+ * @brief 	Maps length bytes at an address that is a multiple of alignment.
  *
- * @param ch 	Pointer to the chunk to be freed.
+ * @details
+ * 		Over-maps by alignment and unmaps the excess on both sides.
  *
- * @return  	void, asserts on munmap failure.
+ * @param length 	The size of the mapping.
+ * @param alignment 	A power of two larger than the page size.
+ * @param prot 		The protection of the mapping.
+ * @param map_flags 	Extra mmap flags.
+ *
+ * @return 	The mapping, or MAP_FAILED.
  */
-void free_chunk(chunk* chunk)
+GLAD_DEF void* glad_mmap_aligned(ptrdiff_t length, ptrdiff_t alignment, int prot, int map_flags)
 {
-	if (!chunk) return;
-	ptrdiff_t allocation_size = CHUNK_ALLOC_SIZE(chunk->ch_size);
-	int check = munmap(chunk, allocation_size);	
-	assert(!check);
+	ptrdiff_t padded = length + alignment;
+	if (padded < length)
+		return MAP_FAILED;
+
+	char* mapping = (char*)glad_mmap(padded, prot, map_flags);
+	if (mapping == (char*)MAP_FAILED)
+		return MAP_FAILED;
+
+	char* aligned = (char*)ROUND_UP((uintptr_t)mapping, (uintptr_t)alignment);
+	if (aligned > mapping)
+		munmap(mapping, aligned - mapping);
+	if (mapping + padded > aligned + length)
+		munmap(aligned + length, (mapping + padded) - (aligned + length));
+	return aligned;
 }
 
 /** 
- * @brief 	Allocates num_bytes in the given arena.
- * 
+ * @brief 	Replaces whole pages of private memory with zero-filled ones.
+ *
  * @details
- * 		Uses mmap to allocate a chunk of memory with at least enough room
- * 		for the chunk struct itself and size*sizeof(char) bytes.
+ * 		On Linux madvise(MADV_DONTNEED) drops the pages and the next touch
+ * 		faults in zero pages. Other systems may keep the contents after
+ * 		MADV_DONTNEED, and strict C modes may not declare it at all, so 
+ * 		there the range is mapped over with MAP_FIXED instead.
+ * 		The pages stop counting against RSS until they are touched again.
  *
- * @param arena 	The arena in which memory will be allocated.
- * @param num_bytes Number of bytes to allocate.
- * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory.
- 
- * @return 	A pointer to the start of the allocated memory region. Null if the 
- * 		allocation fails. 
+ * @param start 	Page-aligned start of the range.
+ * @param length 	Size of the range, a multiple of the page size.
+ *
+ * @return 	0 on success, -1 if the pages were left as they were.
  */
-void* arena_alloc(arena* arena, const ptrdiff_t num_bytes, const ptrdiff_t alignment, int flags)
+GLAD_DEF int glad_discard(void* start, ptrdiff_t length)
 {
-    if (!arena || !num_bytes || !alignment || alignment & (alignment - 1))
-		// alignment must be non-zero, a power of 2, and num_bytes > 0
-        return 0;
-
-    // Calculate the aligned size for allocation
-    ptrdiff_t alloc_size = ROUND_UP(num_bytes, alignment);
-	ptrdiff_t chunk_size = ROUND_UP(alloc_size, DEFAULT_CHUNK_SIZE);
-    void* start_addr = 0;
-
-    // Initialize arena if empty
-    if (!arena->ar_tail) {
-        assert(!arena->ar_head);
-        chunk* new_head = alloc_chunk(chunk_size, flags);
-        if (!new_head) return 0;
-        arena->ar_head = new_head;
-        arena->ar_tail = arena->ar_head;
-    }
-
-    // Find a chunk that can accommodate the allocation
-    chunk* cursor = arena->ar_head;
-    while (cursor) {
-        void* current_address = &cursor->ch_data[cursor->ch_offset];
-        uintptr_t misalignment = (uintptr_t)current_address % alignment;
-
-        // Adjust the offset if the address is misaligned
-        if (misalignment) {
-            cursor->ch_offset += alignment - misalignment;
-        }
-
-        if (cursor->ch_size - cursor->ch_offset >= alloc_size) {
-            start_addr = &cursor->ch_data[cursor->ch_offset];
-            cursor->ch_offset += alloc_size;
-            return start_addr;
-        }
-        cursor = cursor->ch_next;
-    }
-
-    // Allocate a new chunk if needed and align start address
-    chunk* new_chunk = alloc_chunk(chunk_size, flags);
-    if (!new_chunk) return 0;
-
-    // Ensure new chunk start address is aligned
-	void* current_address = new_chunk->ch_data;
-	uintptr_t misalignment = (uintptr_t)current_address % alignment;
-
-	// Adjust the offset if the address is misaligned
-	if (misalignment) {
-		new_chunk->ch_offset += alignment - misalignment;
-	}
-    start_addr = &new_chunk->ch_data[new_chunk->ch_offset];
-    new_chunk->ch_offset += alloc_size;
-
-    // Link new chunk to arena
-    arena->ar_tail->ch_next = new_chunk;
-    arena->ar_tail = new_chunk;
-    return start_addr;
+#if defined(__linux__) && defined(MADV_DONTNEED)
+	return madvise(start, length, MADV_DONTNEED);
+#elif !defined(GLAD_DEVZERO)
+	void* mapping = mmap(start, length, PROT_READ | PROT_WRITE, 
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+	return mapping == MAP_FAILED ? -1 : 0;
+#else
+	int fd = open("/dev/zero", O_RDWR);
+	if (fd == -1)
+		return -1;
+
+	void* mapping = mmap(start, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+	close(fd);
+	return mapping == MAP_FAILED ? -1 : 0;
+#endif
 }
 
 /** 
- * @brief	Gets the total in-use size of the arena.
- * 
- * @details
- * 		Size is measured in (sizeof char).
+ * @brief	Touches every page of a range for writing, in one system call.
  *
- * @param arena The arena for which to calculate the in-use size.
+ * @details
+ * 		Fresh chunks are faulted in a page at a time as a copy reaches them.
+ * 		MADV_POPULATE_WRITE (Linux 5.14) maps all of them up front instead.
+ * 		Only whole pages are populated, and nothing happens where it is 
+ * 		not supported.
  *
- * @return 	The computed size.
+ * @param start The start of the range.
+ * @param length The size of the range.
  */
-ptrdiff_t arena_get_size(arena* arena)
+GLAD_DEF void glad_prefault(void* start, ptrdiff_t length)
 {
-	if (!arena)
-		return 0;
-
-	chunk* cursor = arena->ar_head;
-	ptrdiff_t size = 0;
-	while (cursor) {
-		size += cursor->ch_offset;
-		cursor = cursor->ch_next;	
-	}
-
-	return size;
-};
-
+#ifdef MADV_POPULATE_WRITE
+	uintptr_t page = sysconf(_SC_PAGESIZE);
+	uintptr_t begin = ROUND_UP((uintptr_t)start, page);
+	uintptr_t end = ((uintptr_t)start + length) & -page;
+	if (end > begin)
+		madvise((void*)begin, end - begin, MADV_POPULATE_WRITE);
+#else
+	(void)start;
+	(void)length;
+#endif
+}
 
+#ifdef GLAD_STREAM
 /** 
- * @brief	Pushes the buffer onto the arena.
- * 
- * @param arena The arena to which data will be pushed.
- * @param data 	Pointer to the data buffer to push onto the arena.
- * @param size 	Number of bytes in the data buffer.
- * @param flags Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory.
+ * @brief	Copies with AVX-512 non-temporal stores.
  *
- * @return 	A pointer to the start of the newly allocated region.
+ * @details
+ * 		The destination is aligned to 64 bytes with a plain copy of the 
+ * 		first bytes, then written a cache line at a time, four per round,
+ * 		while the source is prefetched ahead. The tail goes through memcpy.
  */
-void* arena_push(arena* arena, void* data, ptrdiff_t size, ptrdiff_t alignment, int flags)
+GLAD_TARGET("avx512f") GLAD_DEF void glad_stream_avx512(char* GLAD_RESTRICT dst, const char* GLAD_RESTRICT src, ptrdiff_t size)
 {
-	if (!arena || !data) 
-		return 0;
+	ptrdiff_t head = (ptrdiff_t)(-(uintptr_t)dst & 63);
+	if (head > size)
+		head = size;
+	memcpy(dst, src, head);
+	dst += head;
+	src += head;
+	size -= head;
+	for (; size >= 256; size -= 256, dst += 256, src += 256) {
+		_mm_prefetch(src + GLAD_PREFETCH_DISTANCE, _MM_HINT_NTA);
+		_mm_prefetch(src + GLAD_PREFETCH_DISTANCE + 128, _MM_HINT_NTA);
+		__m512i a = _mm512_loadu_si512((const void*)src);
+		__m512i b = _mm512_loadu_si512((const void*)(src + 64));
+		__m512i c = _mm512_loadu_si512((const void*)(src + 128));
+		__m512i d = _mm512_loadu_si512((const void*)(src + 192));
+		_mm512_stream_si512((__m512i*)dst, a);
+		_mm512_stream_si512((__m512i*)(dst + 64), b);
+		_mm512_stream_si512((__m512i*)(dst + 128), c);
+		_mm512_stream_si512((__m512i*)(dst + 192), d);
+	}
+	/* streaming stores are weakly ordered, later plain stores must not pass them */
+	_mm_sfence();
+	memcpy(dst, src, size);
+}
 
-	void* start_addr = arena_alloc(arena, size, alignment, flags);
-	if (!start_addr) return 0;
-	memcpy(start_addr, data, size);
-	return start_addr;
+/** 
+ * @brief	Copies with AVX2 non-temporal stores, see glad_stream_avx512.
+ */
+GLAD_TARGET("avx2") GLAD_DEF void glad_stream_avx2(char* GLAD_RESTRICT dst, const char* GLAD_RESTRICT src, ptrdiff_t size)
+{
+	ptrdiff_t head = (ptrdiff_t)(-(uintptr_t)dst & 31);
+	if (head > size)
+		head = size;
+	memcpy(dst, src, head);
+	dst += head;
+	src += head;
+	size -= head;
+	for (; size >= 128; size -= 128, dst += 128, src += 128) {
+		_mm_prefetch(src + GLAD_PREFETCH_DISTANCE, _MM_HINT_NTA);
+		_mm_prefetch(src + GLAD_PREFETCH_DISTANCE + 64, _MM_HINT_NTA);
+		__m256i a = _mm256_loadu_si256((const __m256i*)src);
+		__m256i b = _mm256_loadu_si256((const __m256i*)(src + 32));
+		__m256i c = _mm256_loadu_si256((const __m256i*)(src + 64));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(src + 96));
+		_mm256_stream_si256((__m256i*)dst, a);
+		_mm256_stream_si256((__m256i*)(dst + 32), b);
+		_mm256_stream_si256((__m256i*)(dst + 64), c);
+		_mm256_stream_si256((__m256i*)(dst + 96), d);
+	}
+	_mm_sfence();
+	memcpy(dst, src, size);
 }
+#endif
 
 /** 
- * @brief	Crops the arena to its final in-use element and coalesces the chunks.
- * 
+ * @brief	Copies size bytes into memory that is not about to be read back.
+ *
  * @details
- * 		This coalescing resolves internal fragmentation of each chunk by
- * 		copying over only the allocated portions.
+ * 		Below GLAD_STREAM_SIZE this is memcpy. Larger copies prefault the 
+ * 		destination and, where the CPU has AVX-512 or AVX2, write it with 
+ * 		non-temporal stores, so the copy does not evict the caller's 
+ * 		working set to make room for data nobody reads soon. The kernel 
+ * 		is picked at run time, so builds don't need -mavx2.
  *
- * @param arena The arena to crop and coalesce.
- * @param flags Flags that modify behavior, e.g., `ZEROMEM` for zeroing memory.
+ * @param dst 	The destination, which must not overlap src.
+ * @param src 	The source.
+ * @param size 	The number of bytes to copy.
  *
- * @return 	A pointer to the start of the newly allocated region.
+ * @return 	dst.
  */
-void* arena_crop_and_coalesce(arena* arena, int flags)
+GLAD_DEF void* glad_copy(void* GLAD_RESTRICT dst, const void* GLAD_RESTRICT src, ptrdiff_t size)
 {
-	if (!arena)
-		return 0;	
+	if (size < GLAD_STREAM_SIZE)
+		return memcpy(dst, src, size);
 
-	ptrdiff_t alloc_size = arena_get_size(arena);
-	chunk* cropped = alloc_chunk(alloc_size, flags); 
+	glad_prefault(dst, size);
+#ifdef GLAD_STREAM
+	if (__builtin_cpu_supports("avx512f")) {
+		glad_stream_avx512((char*)dst, (const char*)src, size);
+		return dst;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		glad_stream_avx2((char*)dst, (const char*)src, size);
+		return dst;
+	}
+#endif
+	return memcpy(dst, src, size);
+}
 
-	if (!cropped)
-		return 0;
+#ifdef GLAD_THREADS
+/* Shared by the threads of glad_run, which take task indices in turn. */
+typedef struct glad_run_state glad_run_state;
+struct glad_run_state {
+	void (*rs_task)(void*, ptrdiff_t);
+	void* rs_arg;
+	ptrdiff_t rs_count;
+	ptrdiff_t rs_next;	/* next index to hand out, taken atomically */
+};
 
-	chunk* cursor = arena->ar_head;
-	ptrdiff_t curr_offset = 0;
-	while (cursor) {
-		memcpy(&cropped->ch_data[curr_offset],
-				cursor->ch_data,
-				sizeof(char) * cursor->ch_offset);
-		curr_offset += cursor->ch_offset;
-		chunk* prev = cursor;
-		cursor = cursor->ch_next;	
-		free_chunk(prev);
+/** 
+ * @brief	Runs tasks of a glad_run_state until none are left.
+ */
+GLAD_DEF void* glad_run_worker(void* arg)
+{
+	glad_run_state* state = (glad_run_state*)arg;
+	for (;;) {
+		ptrdiff_t index = __atomic_fetch_add(&state->rs_next, 1, __ATOMIC_RELAXED);
+		if (index >= state->rs_count)
+			return 0;
+		state->rs_task(state->rs_arg, index);
 	}
-		
-	arena->ar_head = cropped;
-	arena->ar_tail = arena->ar_head;
-	return cropped->ch_data;
 }
+#endif
 
 /** 
- * @brief 	Clears the given arena without freeing the memory.
+ * @brief	Runs count independent tasks through an executor.
  *
  * @details
- *		Marks the chunks as empty again so that they may be used.
+ * 		Without an executor the tasks run one after the other on the 
+ * 		calling thread. An executor with ex_run hands them to it. Otherwise
+ * 		ex_threads threads, the caller included, take them in turn, and 
+ * 		are joined before this returns. Without GLAD_THREADS the tasks 
+ * 		always run on the calling thread.
  *
- * @param arena The arena to clear.
+ * @param executor 	How to run the tasks, or 0.
+ * @param task 		Called as task(arg, i) for every i in [0, count).
+ * @param arg 		Passed to every task.
+ * @param count 	The number of tasks.
  */
-void arena_clear(arena* arena)
+GLAD_DEF void glad_run(const glad_executor* executor, void (*task)(void*, ptrdiff_t), void* arg, ptrdiff_t count)
 {
-	if (!arena)
+	if (executor && executor->ex_run && count > 1) {
+		executor->ex_run(executor->ex_data, task, arg, count);
 		return;
+	}
+#ifdef GLAD_THREADS
+	if (executor && count > 1) {
+		glad_run_state state = { task, arg, count, 0 };
+		ptrdiff_t threads = executor->ex_threads > 0 ? executor->ex_threads : sysconf(_SC_NPROCESSORS_ONLN);
+		if (threads > count)
+			threads = count;
+		if (threads > GLAD_MAX_THREADS)
+			threads = GLAD_MAX_THREADS;
 
-	chunk* cursor = arena->ar_head;
-	while (cursor) {
-		memset(cursor->ch_data, 0, sizeof(char) * cursor->ch_size);
-		cursor->ch_offset = 0;
-		cursor = cursor->ch_next;	
+		/* threads that can't be started just leave more for the others */
+		pthread_t workers[GLAD_MAX_THREADS];
+		int started = 0;
+		for (ptrdiff_t i = 1; i < threads; ++i)
+			started += !pthread_create(&workers[started], 0, glad_run_worker, &state);
+		glad_run_worker(&state);
+		for (int i = 0; i < started; ++i)
+			pthread_join(workers[i], 0);
+		return;
 	}
+#endif
+	for (ptrdiff_t i = 0; i < count; ++i)
+		task(arg, i);
 }
 
 /** 
- * @brief 	Marks whole arena as unallocated.
+ * @brief	Queues a copy for copy_batch_run, in slices of DEFAULT_COPY_SLICE bytes.
  *
  * @details
- * 		Does not set the associated memory. Use with care.
+ * 		Without a batch, or if the queue can't grow, the copy is done on 
+ * 		the spot instead.
  *
- * @param arena The arena to reset.
+ * @param batch The batch to add to, or 0.
+ * @param dst 	The destination, which must stay valid until the batch runs.
+ * @param src 	The source, likewise.
+ * @param size 	The number of bytes to copy.
  */
-void arena_reset(arena* arena)
+GLAD_DEF void copy_batch_add(glad_copy_batch* batch, char* dst, const char* src, ptrdiff_t size)
 {
-	if (!arena)
-		return;
-
-	chunk* cursor = arena->ar_head;
-	while (cursor) {
-		cursor->ch_offset = 0;
-		cursor = cursor->ch_next;	
+	for (ptrdiff_t done = 0; done < size; done += DEFAULT_COPY_SLICE) {
+		ptrdiff_t slice = size - done < DEFAULT_COPY_SLICE ? size - done : DEFAULT_COPY_SLICE;
+		if (batch && batch->cb_count == batch->cb_cap) {
+			ptrdiff_t cap = batch->cb_cap ? batch->cb_cap * 2 : 64;
+			glad_copy_job* jobs = (glad_copy_job*)realloc(batch->cb_jobs, cap * sizeof *jobs);
+			if (jobs) {
+				batch->cb_jobs = jobs;
+				batch->cb_cap = cap;
+			}
+		}
+		if (!batch || batch->cb_count == batch->cb_cap) {
+			glad_copy(dst + done, src + done, slice);
+			continue;
+		}
+		glad_copy_job* job = &batch->cb_jobs[batch->cb_count++];
+		job->cj_dst = dst + done;
+		job->cj_src = src + done;
+		job->cj_size = slice;
 	}
 }
 
 /** 
- * @brief  Frees the given arena.
- *
- * @param arena The arena to free.
- * @param flags Flags that modify free behavior, e.g., `ZEROMEM` for zeroing memory.
+ * @brief	Runs the copy at index of a batch, for glad_run.
  */
-void arena_free(arena* arena, int flags)
+GLAD_DEF void copy_batch_task(void* arg, ptrdiff_t index)
 {
-	if (!arena)
-		return;
+	glad_copy_job* job = &((glad_copy_job*)arg)[index];
+	glad_copy(job->cj_dst, job->cj_src, job->cj_size);
+}
 
-	chunk* cursor = arena->ar_head;
-	while (cursor) {
-		if (flags & ZEROMEM) {
-			memset(cursor, 0, CHUNK_ALLOC_SIZE(cursor->ch_size));
-		}
-		chunk* prev = cursor;
-		cursor = cursor->ch_next;	
-		free_chunk(prev);
-	}
-}	
+/** 
+ * @brief	Runs the queued copies of a batch through executor and empties it.
+ */
+GLAD_DEF void copy_batch_run(glad_copy_batch* batch, const glad_executor* executor)
+{
+	glad_run(executor, copy_batch_task, batch->cb_jobs, batch->cb_count);
+	free(batch->cb_jobs);
+	memset(batch, 0, sizeof *batch);
+}
 
 /** 
- * @brief	Copies arena copy_src to copy_dst.
- * 
+ * @brief	Sets the NUMA policy of a range to prefer the given node.
+ *
  * @details
- * 		Any allocation failure results in cleanup.
- * 
- * @param copy_dst 	The destination arena to which data will be copied.
- * @param copy_src 	The source arena from which data will be copied.
- * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory.
+ * 		Calls mbind(2) with MPOL_PREFERRED, so pages faulted in later come
+ * 		from the node while it has memory, and with MPOL_MF_MOVE, so pages
+ * 		that are already there move to it. Without GLAD_NUMA it does nothing.
+ *
+ * @param start 	The start of the range, page-aligned.
+ * @param length 	The size of the range.
+ * @param node 		The node, below GLAD_MAX_NODES.
+ *
+ * @return 	0 on success, -1 with errno set on failure.
  */
-void arena_copy(arena *restrict copy_dst, const arena *restrict copy_src, int flags)
+GLAD_DEF int glad_mbind(void* start, ptrdiff_t length, int node)
 {
-	if (!copy_dst || !copy_src) 
-		return;
-	if (!copy_src->ar_head || !copy_src->ar_tail)
-		return;
-	
-	/* allocate the head of our new list */	
-	chunk *dst_head = alloc_chunk(copy_src->ar_head->ch_size, flags);
-	dst_head->ch_offset = copy_src->ar_head->ch_offset;
-	dst_head->ch_size = copy_src->ar_head->ch_size;
-	memcpy(dst_head->ch_data,
-			copy_src->ar_head->ch_data, 
-			sizeof(char) * copy_src->ar_head->ch_offset);
-	copy_dst->ar_head = dst_head;
-	copy_dst->ar_tail = copy_dst->ar_head;
-
+	if (node < 0 || node >= GLAD_MAX_NODES) {
+		errno = EINVAL;
+		return -1;
+	}
+#ifdef GLAD_NUMA
+	unsigned long mask[GLAD_MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+	mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+	/* the kernel ignores the last bit of maxnode */
+	return (int)syscall(SYS_mbind, start, length, GLAD_MPOL_PREFERRED, mask, GLAD_MAX_NODES + 1, GLAD_MPOL_MF_MOVE);
+#else
+	(void)start;
+	(void)length;
+	return 0;
+#endif
+}
+
+/** 
+ * @brief	Returns the number of NUMA nodes the system can have.
+ *
+ * @return 	One more than the highest node in /sys/devices/system/node/possible,
+ * 		1 if it can't be read or without GLAD_NUMA.
+ */
+GLAD_DEF int glad_node_count(void)
+{
+	int count = 1;
+#ifdef GLAD_NUMA
+	/* a list of ranges like "0-1,4", the last number is the highest node */
+	FILE* possible = fopen("/sys/devices/system/node/possible", "r");
+	if (!possible)
+		return 1;
+	int node = 0;
+	int c;
+	while ((c = fgetc(possible)) != EOF) {
+		if (c >= '0' && c <= '9') {
+			node = node * 10 + (c - '0');
+		} else {
+			if (node + 1 > count)
+				count = node + 1;
+			node = 0;
+		}
+	}
+	if (node + 1 > count)
+		count = node + 1;
+	fclose(possible);
+	if (count > GLAD_MAX_NODES)
+		count = GLAD_MAX_NODES;
+#endif
+	return count;
+}
+
+/** 
+ * @brief	Returns the NUMA node of the CPU the calling thread runs on.
+ *
+ * @return 	The node, 0 if getcpu(2) fails or without GLAD_NUMA.
+ */
+GLAD_DEF int glad_current_node(void)
+{
+#ifdef GLAD_NUMA
+	unsigned cpu = 0;
+	unsigned node = 0;
+	if (!syscall(SYS_getcpu, &cpu, &node, 0) && node < GLAD_MAX_NODES)
+		return (int)node;
+#endif
+	return 0;
+}
+
+#ifdef GLAD_MEMFD
+/** 
+ * @brief 	Maps length bytes of a new memfd that is file_length bytes long.
+ *
+ * @param length 	The size of the mapping.
+ * @param file_length 	The size of the file, at most length.
+ * @param prot 		The protection of the mapping.
+ * @param map_flags 	Extra mmap flags.
+ * @param fd 		Set to the memfd on success.
+ *
+ * @return 	The MAP_SHARED mapping, or MAP_FAILED.
+ */
+GLAD_DEF void* glad_mmap_memfd(ptrdiff_t length, ptrdiff_t file_length, int prot, int map_flags, int* fd)
+{
+	/* 1 is MFD_CLOEXEC */
+	int memfd = (int)syscall(SYS_memfd_create, "glad", 1);
+	if (memfd == -1)
+		return MAP_FAILED;
+
+	void* mapping = MAP_FAILED;
+	if (!ftruncate(memfd, file_length))
+		mapping = mmap(0, length, prot, MAP_SHARED | map_flags, memfd, 0);
+	if (mapping == MAP_FAILED) {
+		close(memfd);
+		return MAP_FAILED;
+	}
+	*fd = memfd;
+	return mapping;
+}
+
+/** 
+ * @brief 	Maps a file copy-on-write, read-write up to committed and PROT_NONE after.
+ *
+ * @details
+ * 		With addr set the mapping replaces whatever is mapped there. If it
+ * 		can't be made writable, a shared mapping of the committed part is
+ * 		put back, so the old contents stay reachable.
+ *
+ * @param addr 		Where to map, or 0 to let the kernel choose.
+ * @param fd 		The file to map.
+ * @param committed 	Bytes at the start that are read-write.
+ * @param length 	The size of the mapping.
+ * @param map_flags 	Extra mmap flags, e.g. MAP_NORESERVE.
+ *
+ * @return 	The mapping, or MAP_FAILED.
+ */
+GLAD_DEF void* glad_mmap_private(void* addr, int fd, ptrdiff_t committed, ptrdiff_t length, int map_flags)
+{
+	map_flags |= MAP_PRIVATE | (addr ? MAP_FIXED : 0);
+	void* mapping = mmap(addr, length, PROT_NONE, map_flags, fd, 0);
+	if (mapping == MAP_FAILED)
+		return MAP_FAILED;
+	if (!mprotect(mapping, committed, PROT_READ | PROT_WRITE))
+		return mapping;
+
+	if (addr)
+		mmap(addr, committed, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+	else
+		munmap(mapping, length);
+	return MAP_FAILED;
+}
+#endif
+
+/** 
+ * @brief	Returns the header of a CHUNK_FILE chunk's image.
+ */
+GLAD_DEF arena_image* chunk_image(chunk* ch)
+{
+	return (arena_image*)((char*)ch - GLAD_IMAGE_OFFSET);
+}
+
+/** 
+ * @brief	Commits the chunk so that at least end bytes of ch_data are usable.
+ *
+ * @details
+ * 		Only does work for `RESERVE` chunks, whose pages past ch_commit are
+ * 		PROT_NONE. Commits in DEFAULT_COMMIT_SIZE steps, or huge pages for 
+ * 		huge page chunks, but never past ch_size. CHUNK_FILE chunks grow
+ * 		their file instead and map the new part over the reservation.
+ *
+ * @param ch 	The chunk to commit.
+ * @param end 	Number of bytes from the start of ch_data that must be usable.
+ *
+ * @return 	1 on success, 0 if end is past ch_size or the pages can't be committed.
+ */
+GLAD_DEF int chunk_commit(chunk* ch, ptrdiff_t end)
+{
+	if (end <= ch->ch_commit)
+		return 1;
+	if (end > ch->ch_size)
+		return 0;
+
+	ptrdiff_t step = ch->ch_flags & CHUNK_THP ? GLAD_HUGE_PAGE_SIZE : DEFAULT_COMMIT_SIZE;
+	ptrdiff_t committed = CHUNK_ALLOC_SIZE(ch->ch_commit);
+	ptrdiff_t mapped = CHUNK_ALLOC_SIZE(ch->ch_size);
+	ptrdiff_t target = ROUND_UP((ptrdiff_t)CHUNK_ALLOC_SIZE(end), step);
+	if (target > mapped || target < end)
+		target = mapped;
+
+	if (ch->ch_flags & CHUNK_FILE) {
+		off_t file_offset = GLAD_IMAGE_OFFSET + committed;
+		if (ftruncate(ch->ch_fd, GLAD_IMAGE_OFFSET + target)
+				|| mmap((char*)ch + committed, target - committed, PROT_READ | PROT_WRITE,
+					MAP_SHARED | MAP_FIXED, ch->ch_fd, file_offset) == MAP_FAILED)
+			return 0;
+	} else if (mprotect((char*)ch + committed, target - committed, PROT_READ | PROT_WRITE)) {
+		return 0;
+	}
+#ifdef GLAD_THREADS
+	/* carena_alloc reads ch_commit without holding the lock */
+	__atomic_store_n(&ch->ch_commit, target - (ptrdiff_t)sizeof(chunk), __ATOMIC_RELEASE);
+#else
+	ch->ch_commit = target - sizeof(chunk);
+#endif
+	return 1;
+}
+
+/** 
+ * @brief 	Allocates a single chunk with at least the specified size.
+ * 
+ * @details
+ * 		Uses mmap to allocate a chunk of memory with at least enough room
+ *		for the chunk struct itself and size*sizeof(char) bytes. Fresh 
+ *		mappings are zero-filled by the kernel, so they are never memset.
+ *
+ *		With `HUGETLB` or `HUGEPAGE` the mapping is rounded up to 
+ *		GLAD_HUGE_PAGE_SIZE and ch_size grows to match. `HUGETLB` falls 
+ *		back to transparent huge pages when no hugetlb pages are available,
+ *		and to normal pages where the system supports neither.
+ *
+ *		With `RESERVE` the mapping is only reserved (PROT_NONE) and pages
+ *		are committed by chunk_commit as the chunk fills up. `HUGETLB` is
+ *		treated as `HUGEPAGE` then.
+ *
+ *		GLAD_GUARD builds follow the mapping with a PROT_NONE guard page,
+ *		except for hugetlb mappings, which can't be split.
+ *
+ *		With `SNAPSHOT` the chunk is a shared mapping of a memfd of its
+ *		own, so that chunk_snapshot can map it copy-on-write. Huge page
+ *		flags are ignored then. Where memfds are not available the chunk
+ *		is an ordinary one.
+ *
+ * @param size 	The minimum number of bytes to allocate in the chunk.
+ * @param flags Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory,
+ * 		`HUGEPAGE` or `HUGETLB` for huge pages, `RESERVE` to commit lazily,
+ * 		`SNAPSHOT` for memfd backing.
+ *
+ * @return 	A pointer to the allocated chunk. If mmap fails for any reason, this
+ * 		function returns 0.
+ */
+GLAD_DEF chunk* alloc_chunk(ptrdiff_t size, int flags)
+{
+	if (size <= 0)
+		return 0;
+
+	ptrdiff_t allocation_size = CHUNK_ALLOC_SIZE(size);
+	
+	if (allocation_size < size)
+		return 0;
+
+	/* memfd chunks use ordinary pages */
+	if (flags & SNAPSHOT)
+		flags &= ~(HUGEPAGE | HUGETLB);
+
+	int prot = PROT_READ | PROT_WRITE;
+	int map_flags = 0;
+	if (flags & RESERVE) {
+		/* hugetlb pages can't be committed piecemeal */
+		if (flags & HUGETLB)
+			flags = (flags & ~HUGETLB) | HUGEPAGE;
+		prot = PROT_NONE;
+#ifdef MAP_NORESERVE
+		map_flags = MAP_NORESERVE;
+#endif
+		allocation_size = ROUND_UP(allocation_size, (ptrdiff_t)sysconf(_SC_PAGESIZE));
+		if (allocation_size < size)
+			return 0;
+		size = allocation_size - sizeof(chunk);
+	}
+
+	chunk* ret_chunk = (chunk*)MAP_FAILED;
+	int chunk_flags = flags & RESERVE ? CHUNK_RESERVE : 0;
+	int fd = -1;
+	if (flags & (HUGEPAGE | HUGETLB)) {
+		allocation_size = ROUND_UP(allocation_size, GLAD_HUGE_PAGE_SIZE);
+		if (allocation_size < size)
+			return 0;
+		size = allocation_size - sizeof(chunk);
+	}
+
+	/* bytes mapped past allocation_size, up to and including the guard page */
+	ptrdiff_t guard = 0;
+#ifdef GLAD_GUARD
+	ptrdiff_t page = sysconf(_SC_PAGESIZE);
+	guard = ROUND_UP(allocation_size, page) + page - allocation_size;
+#endif
+
+	if (flags & (HUGEPAGE | HUGETLB)) {
+#if defined(MAP_HUGETLB) && !defined(GLAD_DEVZERO)
+		if (flags & HUGETLB) {
+#ifdef MAP_HUGE_SHIFT
+			int huge_flags = MAP_HUGETLB | (GLAD_HUGE_PAGE_SHIFT << MAP_HUGE_SHIFT);
+#else
+			int huge_flags = MAP_HUGETLB;
+#endif
+			ret_chunk = (chunk*)glad_mmap(allocation_size, prot, map_flags | huge_flags);
+			if (ret_chunk != MAP_FAILED)
+				chunk_flags |= CHUNK_HUGETLB;
+		}
+#endif
+		if (ret_chunk == MAP_FAILED) {
+			ret_chunk = (chunk*)glad_mmap_aligned(allocation_size + guard, GLAD_HUGE_PAGE_SIZE, prot, map_flags);
+#ifdef MADV_HUGEPAGE
+			if (ret_chunk != MAP_FAILED && !madvise(ret_chunk, allocation_size, MADV_HUGEPAGE))
+				chunk_flags |= CHUNK_THP;
+#endif
+		}
+	} else {
+#ifdef GLAD_MEMFD
+		if (flags & SNAPSHOT) {
+			ret_chunk = (chunk*)glad_mmap_memfd(allocation_size + guard, allocation_size, prot, map_flags, &fd);
+			if (ret_chunk != MAP_FAILED)
+				chunk_flags |= CHUNK_MEMFD;
+		}
+		if (ret_chunk == MAP_FAILED)
+#endif
+		ret_chunk = (chunk*)glad_mmap(allocation_size + guard, prot, map_flags);
+	}
+
+#ifdef GLAD_GUARD
+	if (ret_chunk != MAP_FAILED && !(chunk_flags & CHUNK_HUGETLB)) {
+		if (mprotect((char*)ret_chunk + allocation_size + guard - page, page, PROT_NONE)) {
+			munmap(ret_chunk, allocation_size + guard);
+			ret_chunk = (chunk*)MAP_FAILED;
+		} else {
+			chunk_flags |= CHUNK_GUARD;
+		}
+	}
+#endif
+
+	if (ret_chunk != MAP_FAILED && flags & RESERVE) {
+		/* commit the header and a first step of data */
+		ptrdiff_t step = chunk_flags & CHUNK_THP ? GLAD_HUGE_PAGE_SIZE : DEFAULT_COMMIT_SIZE;
+		ptrdiff_t commit = ROUND_UP((ptrdiff_t)sizeof(chunk), step);
+		if (commit > allocation_size)
+			commit = allocation_size;
+		if (mprotect(ret_chunk, commit, PROT_READ | PROT_WRITE)) {
+			munmap(ret_chunk, allocation_size + guard);
+			ret_chunk = (chunk*)MAP_FAILED;
+		} else {
+			ret_chunk->ch_commit = commit - sizeof(chunk);
+		}
+	} else if (ret_chunk != MAP_FAILED) {
+		ret_chunk->ch_commit = size;
+	}
+
+	if (ret_chunk == MAP_FAILED) {
+		if (fd != -1)
+			close(fd);
+		if (!(flags & SOFTFAIL)) {
+			assert(0);
+		}
+		return 0;	
+	}
+
+	ret_chunk->ch_next = 0;
+	ret_chunk->ch_size = size;
+	ret_chunk->ch_offset = 0;
+	ret_chunk->ch_dirty = 0;
+	ret_chunk->ch_flags = chunk_flags;
+	ret_chunk->ch_fd = fd;
+	return ret_chunk;
+}
+
+/** 
+ * @brief 	Frees the chunk at the provided reference.
+ *
+ * @param ch 	Pointer to the chunk to be freed.
+ *
+ * @return  	void, asserts on munmap failure.
+ */
+GLAD_DEF void free_chunk(chunk* chunk)
+{
+	if (!chunk) return;
+	ptrdiff_t allocation_size = CHUNK_ALLOC_SIZE(chunk->ch_size);
+	/* a later mapping at this address must not inherit the poison */
+	GLAD_UNPOISON(chunk->ch_data, chunk->ch_commit);
+#ifdef GLAD_GUARD
+	if (chunk->ch_flags & CHUNK_GUARD) {
+		ptrdiff_t page = sysconf(_SC_PAGESIZE);
+		allocation_size = ROUND_UP(allocation_size, page) + page;
+	}
+#endif
+	int fd = chunk->ch_flags & (CHUNK_MEMFD | CHUNK_FILE) ? chunk->ch_fd : -1;
+	void* mapping = chunk;
+	if (chunk->ch_flags & CHUNK_MAPPED) {
+		/* ch_data is page-aligned, the header ends the page before it */
+		ptrdiff_t page = sysconf(_SC_PAGESIZE);
+		mapping = chunk->ch_data - page;
+		allocation_size = page + chunk->ch_size;
+	}
+	if (chunk->ch_flags & CHUNK_FILE) {
+		/* what was allocated stays in the image for the next arena_file_open */
+		chunk_image(chunk)->im_used = chunk->ch_offset;
+		mapping = chunk_image(chunk);
+		allocation_size += GLAD_IMAGE_OFFSET;
+	}
+	int check = munmap(mapping, allocation_size);	
+	assert(!check);
+	if (fd != -1)
+		close(fd);
+}
+
+/** 
+ * @brief 	Takes a chunk with room for at least size bytes from the cache.
+ *
+ * @details
+ * 		The smallest idle chunk that fits is reused, and a new one is mapped
+ * 		if none does. Reused chunks keep their ch_dirty mark, so `ZEROMEM` 
+ * 		allocations still zero what was handed out before. `SNAPSHOT`
+ * 		chunks are always mapped fresh, since memfd chunks are never cached.
+ * 		Caches of registered buffers never map, and fail when they run out.
+ *
+ * @param cache The cache to take from, or 0 to always map.
+ * @param size 	The minimum number of bytes to allocate in the chunk.
+ * @param flags Flags that modify allocation behavior, see alloc_chunk.
+ *
+ * @return 	A pointer to the chunk, or 0 on failure.
+ */
+GLAD_DEF chunk* cache_alloc_chunk(chunk_cache* cache, ptrdiff_t size, int flags)
+{
+	if (cache && cache->cc_buffers) {
+		/* registered buffers are all alike, and there are no others */
+		chunk* ch = cache->cc_head;
+		if (!ch || ch->ch_size < size) {
+			if (!(flags & SOFTFAIL)) {
+				assert(0);
+			}
+			return 0;
+		}
+		cache->cc_head = ch->ch_next;
+		cache->cc_bytes -= CHUNK_ALLOC_SIZE(ch->ch_commit);
+		ch->ch_next = 0;
+		GLAD_UNPOISON(ch->ch_data, ch->ch_commit);
+		return ch;
+	}
+	if (!cache || !size || flags & SNAPSHOT)
+		return alloc_chunk(size, flags);
+
+	/* huge page requests are only served by huge page chunks and vice versa */
+	int huge = (flags & (HUGEPAGE | HUGETLB)) != 0;
+	chunk** best = 0;
+	for (chunk** link = &cache->cc_head; *link; link = &(*link)->ch_next) {
+		if (huge != (((*link)->ch_flags & (CHUNK_HUGETLB | CHUNK_THP)) != 0))
+			continue;
+		if ((*link)->ch_size >= size && (!best || (*link)->ch_size < (*best)->ch_size))
+			best = link;
+	}
+	if (!best)
+		return alloc_chunk(size, flags);
+
+	chunk* ret_chunk = *best;
+	*best = ret_chunk->ch_next;
+	cache->cc_bytes -= CHUNK_ALLOC_SIZE(ret_chunk->ch_commit);
+	ret_chunk->ch_next = 0;
+	GLAD_UNPOISON(ret_chunk->ch_data, ret_chunk->ch_commit);
+	return ret_chunk;
+}
+
+/** 
+ * @brief 	Hands a chunk back to the cache.
+ *
+ * @details
+ * 		The chunk is unmapped instead if keeping it would take the cache 
+ * 		past its high-water mark. With cc_madvise set, the pages of an 
+ * 		idle chunk are given back to the kernel lazily via MADV_FREE.
+ *
+ * @param cache The cache to hand the chunk to, or 0 to always unmap.
+ * @param ch 	The chunk. It must not be linked into an arena anymore.
+ */
+GLAD_DEF void cache_free_chunk(chunk_cache* cache, chunk* ch)
+{
+	if (!ch)
+		return;
+
+	/* file-backed pages can't be discarded, and would keep snapshots' files alive */
+	if (ch->ch_flags & (CHUNK_MEMFD | CHUNK_FROZEN | CHUNK_FILE | CHUNK_MAPPED)) {
+		free_chunk(ch);
+		return;
+	}
+
+	/* registered buffers go back as they are, other chunks never join them */
+	if (cache && cache->cc_buffers) {
+		if (!(ch->ch_flags & CHUNK_BUFFER)) {
+			free_chunk(ch);
+			return;
+		}
+		if (ch->ch_offset > ch->ch_dirty)
+			ch->ch_dirty = ch->ch_offset;
+		ch->ch_offset = 0;
+		ch->ch_next = cache->cc_head;
+		cache->cc_head = ch;
+		cache->cc_bytes += CHUNK_ALLOC_SIZE(ch->ch_commit);
+		return;
+	}
+
+	/* only committed memory counts, reservations are nearly free */
+	ptrdiff_t allocation_size = CHUNK_ALLOC_SIZE(ch->ch_commit);
+	ptrdiff_t max_bytes = cache && cache->cc_max_bytes ? cache->cc_max_bytes : DEFAULT_CACHE_SIZE;
+	if (!cache || cache->cc_bytes + allocation_size > max_bytes) {
+		free_chunk(ch);
+		return;
+	}
+
+	if (ch->ch_offset > ch->ch_dirty)
+		ch->ch_dirty = ch->ch_offset;
+	ch->ch_offset = 0;
+
+	if (cache->cc_madvise) {
+		/* only whole pages past the chunk header can be released */
+		uintptr_t page = sysconf(_SC_PAGESIZE);
+		uintptr_t start = ROUND_UP((uintptr_t)ch->ch_data, page);
+		uintptr_t end = (uintptr_t)ch + allocation_size;
+		uintptr_t dirty_end = ROUND_UP((uintptr_t)&ch->ch_data[ch->ch_dirty], page);
+		if (dirty_end < end)
+			end = dirty_end;
+		if (end > start) {
+#ifdef MADV_FREE
+			madvise((void*)start, end - start, MADV_FREE);
+#else
+			if (!glad_discard((void*)start, end - start))
+				ch->ch_dirty = start - (uintptr_t)ch->ch_data;
+#endif
+		}
+	}
+
+	ch->ch_next = cache->cc_head;
+	cache->cc_head = ch;
+	cache->cc_bytes += allocation_size;
+}
+
+/** 
+ * @brief 	Unmaps every chunk held by the cache.
+ *
+ * @param cache The cache to empty.
+ */
+GLAD_DEF void cache_free(chunk_cache* cache)
+{
+	if (!cache)
+		return;
+
+	chunk* cursor = cache->cc_head;
+	while (cursor) {
+		chunk* prev = cursor;
+		cursor = cursor->ch_next;
+		if (!(prev->ch_flags & CHUNK_BUFFER))
+			free_chunk(prev);
+	}
+	cache->cc_head = 0;
+	cache->cc_bytes = 0;
+
+	if (cache->cc_buffers) {
+		/* a later mapping at this address must not inherit the poison */
+		GLAD_UNPOISON(cache->cc_buffers, cache->cc_stride * cache->cc_count);
+		int check = munmap(cache->cc_buffers, cache->cc_stride * cache->cc_count);
+		assert(!check);
+		free(cache->cc_iovecs);
+		cache->cc_buffers = 0;
+		cache->cc_iovecs = 0;
+		cache->cc_count = 0;
+	}
+}
+
+/** 
+ * @brief 	Turns a cache into a fixed set of registered I/O buffers.
+ *
+ * @details
+ * 		Maps count chunks of size usable bytes at once, in one mapping
+ * 		that stays at the same address until cache_free, and faults their
+ * 		pages in. Arenas that use the cache take chunks only from the set 
+ * 		and never map their own, so all their memory lies in buffers that
+ * 		were registered up front. Register cc_iovecs, one entry per chunk's
+ * 		data, with e.g. io_uring_register_buffers(&ring, cache.cc_iovecs,
+ * 		cache.cc_count), and find the buffer index of a region with 
+ * 		cache_buffer_index. Chunks given back stay in the set; they are 
+ * 		never unmapped or discarded, since that would break the kernel's 
+ * 		pinned pages away from the arena's.
+ *
+ * 		Like any chunk_cache, the set is not thread-safe, and allocations
+ * 		larger than a buffer fail.
+ *
+ * @param cache The cache to initialize. Its earlier contents are ignored.
+ * @param size 	The minimum number of usable bytes per buffer.
+ * @param count The number of buffers.
+ * @param flags `HUGEPAGE` or `HUGETLB` to round buffers to huge pages and
+ * 		madvise them for transparent huge pages.
+ *
+ * @return 	0 on success, or an error number.
+ */
+GLAD_DEF int cache_init_buffers(chunk_cache* cache, ptrdiff_t size, int count, int flags)
+{
+	if (!cache || size <= 0 || count <= 0)
+		return EINVAL;
+	memset(cache, 0, sizeof *cache);
+
+	int huge = (flags & (HUGEPAGE | HUGETLB)) != 0;
+	ptrdiff_t page = huge ? GLAD_HUGE_PAGE_SIZE : sysconf(_SC_PAGESIZE);
+	ptrdiff_t stride = ROUND_UP((ptrdiff_t)CHUNK_ALLOC_SIZE(size), page);
+	if (stride < size || stride > PTRDIFF_MAX / count)
+		return EINVAL;
+
+	struct iovec* iovecs = (struct iovec*)calloc(count, sizeof *iovecs);
+	if (!iovecs)
+		return ENOMEM;
+	/* registration pins every page anyway, so populate them up front */
+	int map_flags = 0;
+#ifdef MAP_POPULATE
+	map_flags = MAP_POPULATE;
+#endif
+	char* base = (char*)(huge ? glad_mmap_aligned(stride * count, GLAD_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, map_flags)
+			: glad_mmap(stride * count, PROT_READ | PROT_WRITE, map_flags));
+	if (base == (char*)MAP_FAILED) {
+		free(iovecs);
+		return ENOMEM;
+	}
+
+	int chunk_flags = CHUNK_BUFFER;
+#ifdef MADV_HUGEPAGE
+	if (huge && !madvise(base, stride * count, MADV_HUGEPAGE))
+		chunk_flags |= CHUNK_THP;
+#endif
+	/* listed in address order, so a fresh arena fills buffer 0 first */
+	for (int i = count - 1; i >= 0; --i) {
+		chunk* ch = (chunk*)(base + i * stride);
+		ch->ch_next = cache->cc_head;
+		ch->ch_size = stride - sizeof(chunk);
+		ch->ch_offset = 0;
+		ch->ch_dirty = 0;
+		ch->ch_commit = ch->ch_size;
+		ch->ch_flags = chunk_flags;
+		ch->ch_fd = -1;
+		iovecs[i].iov_base = ch->ch_data;
+		iovecs[i].iov_len = ch->ch_size;
+		cache->cc_head = ch;
+	}
+	cache->cc_bytes = stride * count;
+	cache->cc_max_bytes = cache->cc_bytes;
+	cache->cc_buffers = base;
+	cache->cc_stride = stride;
+	cache->cc_count = count;
+	cache->cc_iovecs = iovecs;
+	return 0;
+}
+
+/** 
+ * @brief 	Returns the registered buffer a region lies in.
+ *
+ * @param cache A cache set up by cache_init_buffers.
+ * @param ptr 	A pointer into one of its chunks, e.g. from arena_alloc.
+ *
+ * @return 	The index of the buffer in cc_iovecs, for io_uring_prep_read_fixed
+ * 		and friends, or -1 if ptr is not in a buffer of the cache.
+ */
+GLAD_DEF int cache_buffer_index(const chunk_cache* cache, const void* ptr)
+{
+	if (!cache || !cache->cc_buffers)
+		return -1;
+
+	uintptr_t offset = (uintptr_t)ptr - (uintptr_t)cache->cc_buffers;
+	if (offset >= (uintptr_t)(cache->cc_stride * cache->cc_count))
+		return -1;
+	int index = (int)(offset / cache->cc_stride);
+	/* the chunk header isn't part of the registered buffer */
+	if ((uintptr_t)ptr < (uintptr_t)cache->cc_iovecs[index].iov_base)
+		return -1;
+	return index;
+}
+
+/** 
+ * @brief	Writes the cached bump pointer back to the current chunk.
+ *
+ * @details
+ * 		arena_alloc only advances ar_ptr on its fast path, so anything that
+ * 		reads ch_offset across the chunk list must call this first.
+ *
+ * @param arena The arena to synchronize.
+ */
+GLAD_DEF void arena_sync(const arena* arena)
+{
+	if (!arena || !arena->ar_curr)
+		return;
+	arena->ar_curr->ch_offset = arena->ar_ptr - arena->ar_curr->ch_data;
+}
+
+/** 
+ * @brief	Makes ch the chunk that the arena bump-allocates from.
+ *
+ * @param arena The arena to update.
+ * @param ch 	The new current chunk, or 0 to detach the bump pointer.
+ */
+GLAD_DEF void arena_set_current(arena* arena, chunk* ch)
+{
+	arena->ar_curr = ch;
+	arena->ar_ptr = ch ? &ch->ch_data[ch->ch_offset] : 0;
+	arena->ar_end = ch ? &ch->ch_data[ch->ch_commit] : 0;
+	arena->ar_zero = ch ? &ch->ch_data[ch->ch_dirty] : 0;
+}
+
+/** 
+ * @brief	Gets the total in-use size of the arena.
+ * 
+ * @details
+ * 		Size is measured in (sizeof char). A running total, so it costs 
+ * 		the same for any number of chunks. Not kept for the inner arena
+ * 		of a carena, use carena_get_size there.
+ *
+ * @param arena The arena for which to calculate the in-use size.
+ *
+ * @return 	The computed size.
+ */
+GLAD_DEF ptrdiff_t arena_get_size(const arena* arena)
+{
+	if (!arena)
+		return 0;
+
+	return arena->ar_used + (arena->ar_curr ? arena->ar_ptr - arena->ar_curr->ch_data : 0);
+}
+
+/** 
+ * @brief	Gets the bytes mapped for the arena's chunks, headers included.
+ *
+ * @details
+ * 		`RESERVE` chunks count their whole reservation. Like arena_get_size,
+ * 		this is a running total and costs the same for any number of chunks.
+ *
+ * @param arena The arena.
+ *
+ * @return 	The mapped size.
+ */
+GLAD_DEF ptrdiff_t arena_get_mapped(const arena* arena)
+{
+	return arena ? arena->ar_mapped : 0;
+}
+
+/** 
+ * @brief	Orders arena_range entries by start address, for qsort.
+ */
+GLAD_DEF int arena_range_cmp(const void* a, const void* b)
+{
+	uintptr_t x = ((const arena_range*)a)->rg_start;
+	uintptr_t y = ((const arena_range*)b)->rg_start;
+	return (x > y) - (x < y);
+}
+
+/** 
+ * @brief	Accounts for a chunk that was just linked into the arena.
+ *
+ * @details
+ * 		Adds it to ar_mapped, st_chunks and the range index. ar_used is left to the
+ * 		caller, which knows whether the chunk became the current one. If the
+ * 		index can't grow it is dropped, and arena_contains walks the list
+ * 		until the next arena_recount.
+ *
+ * @param arena The arena the chunk was linked into.
+ * @param ch 	The chunk.
+ */
+GLAD_DEF void arena_track_chunk(arena* arena, chunk* ch)
+{
+	arena->ar_mapped += CHUNK_ALLOC_SIZE(ch->ch_size);
+	GLAD_STAT(arena->ar_stats.st_chunks += 1);
+	if (arena->ar_range_count < 0)
+		return;
+
+	if (arena->ar_range_count == arena->ar_range_cap) {
+		ptrdiff_t cap = arena->ar_range_cap ? arena->ar_range_cap * 2 : 8;
+		arena_range* ranges = (arena_range*)realloc(arena->ar_ranges, cap * sizeof *ranges);
+		if (!ranges) {
+			free(arena->ar_ranges);
+			arena->ar_ranges = 0;
+			arena->ar_range_cap = 0;
+			arena->ar_range_count = -1;
+			return;
+		}
+		arena->ar_ranges = ranges;
+		arena->ar_range_cap = cap;
+	}
+
+	/* mmap tends to hand out descending addresses, so search rather than append */
+	uintptr_t start = (uintptr_t)ch->ch_data;
+	ptrdiff_t lo = 0, hi = arena->ar_range_count;
+	while (lo < hi) {
+		ptrdiff_t mid = lo + (hi - lo) / 2;
+		if (arena->ar_ranges[mid].rg_start < start)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	memmove(&arena->ar_ranges[lo + 1], &arena->ar_ranges[lo], (arena->ar_range_count - lo) * sizeof *arena->ar_ranges);
+	arena->ar_ranges[lo].rg_start = start;
+	arena->ar_ranges[lo].rg_end = start + ch->ch_size;
+	arena->ar_range_count += 1;
+}
+
+/** 
+ * @brief	Recomputes ar_used, ar_mapped, st_chunks and the range index from the chunk list.
+ *
+ * @details
+ * 		Called after operations that give chunks back or replace them, 
+ * 		which walk the chunk list anyway.
+ *
+ * @param arena The arena to update.
+ */
+GLAD_DEF void arena_recount(arena* arena)
+{
+	arena_sync(arena);
+	ptrdiff_t count = 0;
+	arena->ar_used = 0;
+	arena->ar_mapped = 0;
+	for (chunk* cursor = arena->ar_head; cursor; cursor = cursor->ch_next) {
+		if (cursor != arena->ar_curr)
+			arena->ar_used += cursor->ch_offset;
+		arena->ar_mapped += CHUNK_ALLOC_SIZE(cursor->ch_size);
+		count += 1;
+	}
+#ifdef GLAD_STATS
+	arena->ar_stats.st_chunks = count;
+	if (arena_get_size(arena) > arena->ar_stats.st_peak)
+		arena->ar_stats.st_peak = arena_get_size(arena);
+#endif
+
+	if (count > arena->ar_range_cap) {
+		arena_range* ranges = (arena_range*)realloc(arena->ar_ranges, count * sizeof *ranges);
+		if (!ranges) {
+			arena->ar_range_count = -1;
+			return;
+		}
+		arena->ar_ranges = ranges;
+		arena->ar_range_cap = count;
+	}
+	arena_range* range = arena->ar_ranges;
+	for (chunk* cursor = arena->ar_head; cursor; cursor = cursor->ch_next, ++range) {
+		range->rg_start = (uintptr_t)cursor->ch_data;
+		range->rg_end = range->rg_start + cursor->ch_size;
+	}
+	if (count > 1)
+		qsort(arena->ar_ranges, count, sizeof *arena->ar_ranges, arena_range_cmp);
+	arena->ar_range_count = count;
+}
+
+#ifdef GLAD_STATS
+/** 
+ * @brief	Accounts for memory handed out by the arena.
+ *
+ * @param arena 	The arena to update.
+ * @param allocs 	Number of allocations made, 0 for in-place resizes.
+ * @param requested 	Bytes the caller asked for.
+ * @param consumed 	Bytes the bump pointer moved by, alignment included.
+ */
+GLAD_DEF void arena_stats_add(arena* arena, ptrdiff_t allocs, ptrdiff_t requested, ptrdiff_t consumed)
+{
+	arena_stats* stats = &arena->ar_stats;
+	stats->st_allocs += allocs;
+	stats->st_requested += requested;
+	stats->st_padding += consumed - requested;
+	/* called before the totals move past the new allocation */
+	ptrdiff_t used = arena_get_size(arena) + consumed;
+	if (used > stats->st_peak)
+		stats->st_peak = used;
+}
+
+#endif
+
+/** 
+ * @brief	Zeroes the part of a freshly carved region that may hold old data.
+ *
+ * @details
+ * 		Only memory below ch_dirty has been handed out before, everything
+ * 		past it is still zero from the kernel and is left alone. 
+ *
+ * @param ch 	The chunk the region was carved from.
+ * @param start The start of the region.
+ * @param size 	The size of the region.
+ */
+GLAD_DEF void chunk_zero(chunk* ch, char* start, ptrdiff_t size)
+{
+	ptrdiff_t dirty = &ch->ch_data[ch->ch_dirty] - start;
+	if (dirty > 0)
+		memset(start, 0, dirty < size ? dirty : size);
+}
+
+/** 
+ * @brief	Zeroes the first size bytes of a chunk by discarding its pages.
+ *
+ * @details
+ * 		Whole pages go through glad_discard, only the part of the first
+ * 		page that shares the chunk header is written. Falls back to memset
+ * 		when the pages cannot be discarded.
+ *
+ * @param ch 	The chunk to zero.
+ * @param size 	Number of bytes from the start of ch_data to zero.
+ */
+GLAD_DEF void chunk_discard(chunk* ch, ptrdiff_t size)
+{
+	uintptr_t page = ch->ch_flags & CHUNK_HUGETLB ? GLAD_HUGE_PAGE_SIZE : sysconf(_SC_PAGESIZE);
+	uintptr_t start = ROUND_UP((uintptr_t)ch->ch_data, page);
+	uintptr_t end = ROUND_UP((uintptr_t)&ch->ch_data[size], page);
+	uintptr_t committed = (uintptr_t)ch + CHUNK_ALLOC_SIZE(ch->ch_commit);
+	if (end > committed)
+		end = committed;
+
+	if (end <= start || glad_discard((void*)start, end - start)) {
+		memset(ch->ch_data, 0, size);
+		return;
+	}
+	memset(ch->ch_data, 0, start - (uintptr_t)ch->ch_data);
+}
+
+/** 
+ * @brief	Carves alloc_size bytes at the given alignment out of a chunk.
+ *
+ * @param ch 		The chunk to allocate from.
+ * @param alloc_size 	Number of bytes, already rounded to alignment.
+ * @param alignment 	A power of two.
+ *
+ * @return 	The start of the region, or 0 if the chunk does not have room. 
+ * 		The chunk is left untouched on failure, except that more of a 
+ * 		`RESERVE` chunk may have been committed.
+ */
+GLAD_DEF void* chunk_bump(chunk* ch, ptrdiff_t alloc_size, ptrdiff_t alignment)
+{
+	uintptr_t base = (uintptr_t)ch->ch_data;
+	ptrdiff_t offset = (ptrdiff_t)(ROUND_UP(base + ch->ch_offset, (uintptr_t)alignment) - base);
+
+	if (ch->ch_size - offset < alloc_size || !chunk_commit(ch, offset + alloc_size))
+		return 0;
+
+	ch->ch_offset = offset + alloc_size;
+	return &ch->ch_data[offset];
+}
+
+/** 
+ * @brief	Binds a chunk to the arena's NUMA node, if it has one.
+ *
+ * @details
+ * 		Registered buffers are left alone, since they are shared by every
+ * 		arena on the cache. Does nothing outside GLAD_NUMA builds.
+ *
+ * @param arena The arena the chunk is for.
+ * @param ch 	The chunk, before its data is first touched.
+ */
+GLAD_DEF void arena_bind_chunk(const arena* arena, chunk* ch)
+{
+#ifdef GLAD_NUMA
+	if (arena->ar_node && !(ch->ch_flags & CHUNK_BUFFER))
+		glad_mbind(ch, CHUNK_ALLOC_SIZE(ch->ch_size), arena->ar_node - 1);
+#else
+	(void)arena;
+	(void)ch;
+#endif
+}
+
+/** 
+ * @brief	Takes a new chunk for the arena from its cache, or maps one.
+ *
+ * @details
+ * 		Arenas with ar_node set bind the chunk to their node before any
+ * 		of its data is touched, so the first touch, even the memset of 
+ * 		`ZEROMEM`, faults pages in on the node. Pages of a cached chunk 
+ * 		that were touched on another node are moved. Binding is best 
+ * 		effort; the chunk is used even if mbind fails.
+ *
+ * @param arena The arena the chunk is for.
+ * @param size 	The minimum number of bytes to allocate in the chunk.
+ * @param flags Flags for alloc_chunk, the arena's ar_flags included.
+ *
+ * @return 	A pointer to the chunk, or 0 on failure.
+ */
+GLAD_DEF chunk* arena_new_chunk(arena* arena, ptrdiff_t size, int flags)
+{
+	chunk* ch = cache_alloc_chunk(arena->ar_cache, size, flags);
+	if (ch)
+		arena_bind_chunk(arena, ch);
+	return ch;
+}
+
+/** 
+ * @brief	Picks the size of the next chunk the arena maps.
+ *
+ * @details
+ * 		Chunks start at ar_min_chunk and grow by ar_growth until they reach
+ * 		ar_max_chunk. Sizes count the whole mapping, chunk header included,
+ * 		and are rounded up to the page size. A request larger than the 
+ * 		planned chunk gets a chunk of its own and does not advance the policy.
+ * 		`RESERVE` arenas reserve ar_reserve bytes for every chunk instead.
+ * 		Arenas on registered buffers always get a whole buffer.
+ *
+ * @param arena The arena that needs a new chunk.
+ * @param need 	Minimum number of usable bytes in the chunk.
+ *
+ * @return 	The usable size of the next chunk, or 0 on overflow or if need
+ * 		is larger than a registered buffer.
+ */
+GLAD_DEF ptrdiff_t arena_next_chunk_size(arena* arena, ptrdiff_t need)
+{
+	if (arena->ar_cache && arena->ar_cache->cc_buffers) {
+		/* every chunk is a whole registered buffer */
+		ptrdiff_t size = arena->ar_cache->cc_stride - (ptrdiff_t)sizeof(chunk);
+		return need <= size ? size : 0;
+	}
+
+	ptrdiff_t min = arena->ar_min_chunk ? arena->ar_min_chunk : DEFAULT_CHUNK_SIZE;
+	ptrdiff_t max = arena->ar_max_chunk ? arena->ar_max_chunk : DEFAULT_MAX_CHUNK_SIZE;
+	ptrdiff_t growth = arena->ar_growth ? arena->ar_growth : DEFAULT_GROWTH;
+	ptrdiff_t page = sysconf(_SC_PAGESIZE);
+	if (max < min)
+		max = min;
+
+	ptrdiff_t allocation_size = (ptrdiff_t)CHUNK_ALLOC_SIZE(need);
+	if (allocation_size < need)
+		return 0;
+
+	ptrdiff_t size = arena->ar_next_chunk ? arena->ar_next_chunk : min;
+	if (arena->ar_flags & RESERVE) {
+		/* address space is cheap, so every chunk is a full reservation */
+		size = arena->ar_reserve ? arena->ar_reserve : DEFAULT_RESERVE_SIZE;
+		if (size < allocation_size)
+			size = allocation_size;
+		allocation_size = size;
+	} else if (size >= allocation_size) {
+		arena->ar_next_chunk = size > max / growth ? max : size * growth;
+		allocation_size = size;
+	}
+
+	allocation_size = ROUND_UP(allocation_size, page);
+	if (allocation_size < need)
+		return 0;
+	return allocation_size - (ptrdiff_t)sizeof(chunk);
+}
+
+/** 
+ * @brief 	Slow path of arena_alloc, taken when the current chunk is full.
+ * 
+ * @details
+ * 		Commits more of ar_curr if it is a `RESERVE` chunk, then moves on
+ * 		to the chunks after it (left over from arena_reset), and maps a 
+ * 		new chunk only when none of them fit. With `FIRSTFIT`
+ * 		the search starts from ar_head instead, so older chunks can be
+ * 		back-filled; the current chunk only changes if the fitting chunk 
+ * 		comes at or after it.
+ *
+ * @param arena 	The arena in which memory will be allocated.
+ * @param alloc_size 	Number of bytes, already rounded to alignment.
+ * @param alignment 	A power of two.
+ * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory.
+ *
+ * @return 	A pointer to the allocated region, or 0 on failure.
+ */
+GLAD_NOINLINE void* arena_alloc_slow(arena* arena, ptrdiff_t num_bytes, ptrdiff_t alignment, int flags)
+{
+	ptrdiff_t alloc_size = ROUND_UP(num_bytes, alignment);
+	arena_sync(arena);
+
+	chunk* cursor = arena->ar_head;
+	int past_curr = 0;
+	if (!(flags & FIRSTFIT) && arena->ar_curr) {
+		/* a RESERVE chunk may only need more pages committed */
+		cursor = arena->ar_curr;
+		past_curr = 1;
+	}
+
+	// Find a chunk that can accommodate the allocation
+	for (; cursor; cursor = cursor->ch_next) {
+		past_curr |= cursor == arena->ar_curr;
+		ptrdiff_t offset = cursor->ch_offset;
+		void* start_addr = chunk_bump(cursor, alloc_size, alignment);
+		if (!start_addr)
+			continue;
+		GLAD_STAT(arena_stats_add(arena, 1, num_bytes, cursor->ch_offset - offset));
+		GLAD_UNPOISON(start_addr, alloc_size);
+		if (flags & ZEROMEM)
+			chunk_zero(cursor, (char*)start_addr, alloc_size);
+		/* ar_used leaves out the current chunk, which the bump pointer tracks */
+		if (!past_curr)
+			arena->ar_used += cursor->ch_offset - offset;
+		else if (cursor != arena->ar_curr)
+			arena->ar_used += (arena->ar_curr ? arena->ar_curr->ch_offset : 0) - offset;
+		if (past_curr)
+			arena_set_current(arena, cursor);
+		return start_addr;
+	}
+
+	/* a file-backed arena is the one chunk that lives in the file */
+	if (arena->ar_head && arena->ar_head->ch_flags & CHUNK_FILE)
+		return 0;
+
+	// Leave room to align the start of the new chunk's data
+	ptrdiff_t need = alloc_size + alignment - 1;
+	if (need < alloc_size)
+		return 0;
+	ptrdiff_t chunk_size = arena_next_chunk_size(arena, need);
+	if (!chunk_size)
+		return 0;
+
+	chunk* new_chunk = arena_new_chunk(arena, chunk_size, flags | arena->ar_flags);
+	if (!new_chunk)
+		return 0;
+
+	void* start_addr = chunk_bump(new_chunk, alloc_size, alignment);
+	assert(start_addr);
+	GLAD_STAT(arena_stats_add(arena, 1, num_bytes, new_chunk->ch_offset));
+	if (flags & ZEROMEM)
+		chunk_zero(new_chunk, (char*)start_addr, alloc_size);
+
+	// Link new chunk to arena
+	if (arena->ar_tail)
+		arena->ar_tail->ch_next = new_chunk;
+	else
+		arena->ar_head = new_chunk;
+	arena->ar_tail = new_chunk;
+	arena_track_chunk(arena, new_chunk);
+	arena->ar_used += arena->ar_curr ? arena->ar_curr->ch_offset : 0;
+	arena_set_current(arena, new_chunk);
+	return start_addr;
+}
+
+#ifdef GLAD_GUARD
+/** 
+ * @brief	Gives an allocation a chunk of its own that ends at its guard page.
+ *
+ * @details
+ * 		Used instead of the bump pointer by arenas with ar_guard set, so 
+ * 		that writing past the end of the allocation faults right away. 
+ * 		The chunk is marked full and is never bumped into again. Chunks 
+ * 		do not come from the chunk_cache, whose chunks may be too large
+ * 		to end at the guard page.
+ *
+ * @param arena		The arena to allocate in.
+ * @param num_bytes	The size of the allocation.
+ * @param alignment	The alignment of the allocation.
+ * @param flags 	Flags that modify allocation behavior. Fresh chunks are always zeroed.
+ *
+ * @return	A pointer to the start of the newly allocated region.
+ */
+GLAD_NOINLINE void* arena_alloc_guarded(arena* arena, ptrdiff_t num_bytes, ptrdiff_t alignment, int flags)
+{
+	ptrdiff_t alloc_size = ROUND_UP(num_bytes, alignment);
+	ptrdiff_t page = sysconf(_SC_PAGESIZE);
+	ptrdiff_t need = alloc_size + alignment - 1;
+	if (need < alloc_size)
+		return 0;
+	ptrdiff_t chunk_size = ROUND_UP((ptrdiff_t)CHUNK_ALLOC_SIZE(need), page);
+	if (chunk_size < need)
+		return 0;
+
+	chunk* ch = alloc_chunk(chunk_size - sizeof(chunk), (flags | arena->ar_flags) & SOFTFAIL);
+	if (!ch)
+		return 0;
+	arena_bind_chunk(arena, ch);
+
+	uintptr_t start_addr = (uintptr_t)&ch->ch_data[ch->ch_size - alloc_size] & -(uintptr_t)alignment;
+	ch->ch_offset = ch->ch_size;
+	GLAD_STAT(arena_stats_add(arena, 1, num_bytes, ch->ch_size));
+
+	arena_sync(arena);
+	if (arena->ar_tail)
+		arena->ar_tail->ch_next = ch;
+	else
+		arena->ar_head = ch;
+	arena->ar_tail = ch;
+	arena_track_chunk(arena, ch);
+	arena->ar_used += arena->ar_curr ? arena->ar_curr->ch_offset : 0;
+	arena_set_current(arena, ch);
+	return (void*)start_addr;
+}
+
+/** 
+ * @brief	Unmaps every chunk of an arena with ar_guard set.
+ *
+ * @details
+ * 		Called by arena_reset and arena_clear in place of reusing the 
+ * 		chunks, so that pointers kept across them fault. 
+ *
+ * @param arena The arena to release.
+ */
+GLAD_DEF void arena_release_guarded(arena* arena)
+{
+	chunk* cursor = arena->ar_head;
+	while (cursor) {
+		chunk* prev = cursor;
+		cursor = cursor->ch_next;
+		free_chunk(prev);
+	}
+	arena->ar_head = 0;
+	arena->ar_tail = 0;
+	arena_set_current(arena, 0);
+	arena_recount(arena);
+}
+#endif
+
+/** 
+ * @brief 	Allocates num_bytes in the given arena.
+ * 
+ * @details
+ * 		The common case is a pointer bump within the current chunk. When 
+ * 		that chunk is full, a later chunk is used or a new one is mapped 
+ * 		with at least enough room for the chunk struct itself and
+ * 		size*sizeof(char) bytes.
+ *
+ * @param arena 	The arena in which memory will be allocated.
+ * @param num_bytes Number of bytes to allocate.
+ * @param alignment Alignment of the returned region, must be a power of 2.
+ * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory,
+ * 			`FIRSTFIT` to reuse space in older chunks.
+ 
+ * @return 	A pointer to the start of the allocated memory region. Null if the 
+ * 		allocation fails. 
+ */
+GLAD_DEF void* arena_alloc(arena* arena, const ptrdiff_t num_bytes, const ptrdiff_t alignment, int flags)
+{
+	if (!arena || num_bytes <= 0 || alignment <= 0 || alignment & (alignment - 1))
+		// alignment must be non-zero, a power of 2, and num_bytes > 0
+		return 0;
+
+	// Calculate the aligned size for allocation
+	ptrdiff_t alloc_size = ROUND_UP(num_bytes, alignment);
+	if (alloc_size < num_bytes) {
+		GLAD_STAT(arena->ar_stats.st_failed += 1);
+		return 0;
+	}
+
+#ifdef GLAD_GUARD
+	if (arena->ar_guard) {
+		void* ret = arena_alloc_guarded(arena, num_bytes, alignment, flags);
+		GLAD_STAT(arena->ar_stats.st_failed += !ret);
+		return ret;
+	}
+#endif
+
+	// Fast path: bump the pointer within the current chunk
+	uintptr_t start_addr = ROUND_UP((uintptr_t)arena->ar_ptr, (uintptr_t)alignment);
+	if (!(flags & FIRSTFIT) && (intptr_t)((uintptr_t)arena->ar_end - start_addr) >= alloc_size) {
+		GLAD_STAT(arena_stats_add(arena, 1, num_bytes, (start_addr + alloc_size) - (uintptr_t)arena->ar_ptr));
+		GLAD_UNPOISON((void*)start_addr, alloc_size);
+		arena->ar_ptr = (char*)(start_addr + alloc_size);
+		// Memory that was never handed out is still zero from mmap
+		if (flags & ZEROMEM && start_addr < (uintptr_t)arena->ar_zero)
+			chunk_zero(arena->ar_curr, (char*)start_addr, alloc_size);
+		return (void*)start_addr;
+	}
+
+	void* ret = arena_alloc_slow(arena, num_bytes, alignment, flags);
+	GLAD_STAT(arena->ar_stats.st_failed += !ret);
+	return ret;
+}
+
+/** 
+ * @brief	Allocates a batch of regions of different sizes at once.
+ *
+ * @details
+ * 		The requests are laid out back to back, each at its own alignment,
+ * 		and carved out as a single region aligned to the largest of them. 
+ * 		That is one capacity check instead of one per request, and the 
+ * 		batch moves on to a new chunk at most once. Either every request is
+ * 		served or none is.
+ *
+ * @param arena 	The arena in which memory will be allocated.
+ * @param requests 	The size and alignment of each region.
+ * @param count 	The number of requests.
+ * @param out 		Receives the start of each region, in request order. 
+ * 			Left untouched on failure.
+ * @param flags 	Flags that modify allocation behavior, see arena_alloc.
+ *
+ * @return 	1 on success, 0 if a request is invalid or the allocation fails.
+ */
+GLAD_DEF int arena_alloc_batch(arena* arena, const arena_request* requests, ptrdiff_t count, void** out, int flags)
+{
+	if (!arena || !requests || !out || count <= 0)
+		return 0;
+
+	/* lay the regions out from a base aligned to the largest alignment */
+	ptrdiff_t alignment = 1;
+	ptrdiff_t total = 0;
+	GLAD_STAT(ptrdiff_t requested = 0);
+	for (ptrdiff_t i = 0; i < count; ++i) {
+		ptrdiff_t size = requests[i].rq_size;
+		ptrdiff_t align = requests[i].rq_alignment;
+		if (size <= 0 || align <= 0 || align & (align - 1))
+			return 0;
+		ptrdiff_t offset = ROUND_UP(total, align);
+		ptrdiff_t end = offset + ROUND_UP(size, align);
+		if (offset < total || end < offset + size)
+			return 0;
+		total = end;
+		alignment = align > alignment ? align : alignment;
+		GLAD_STAT(requested += size);
+	}
+
+	char* base = (char*)arena_alloc(arena, total, alignment, flags);
+	if (!base)
+		return 0;
+	/* out is only written once the whole batch has succeeded */
+	total = 0;
+	for (ptrdiff_t i = 0; i < count; ++i) {
+		ptrdiff_t align = requests[i].rq_alignment;
+		out[i] = base + ROUND_UP(total, align);
+		total = ROUND_UP(total, align) + ROUND_UP(requests[i].rq_size, align);
+	}
+	GLAD_STAT(arena_stats_add(arena, count - 1, requested - total, 0));
+	return 1;
+}
+
+/** 
+ * @brief	Allocates count objects of one size as a contiguous array.
+ *
+ * @details
+ * 		Same as a single arena_alloc of the whole array, with the start of
+ * 		each element written to out. Used by glad_new_n.
+ *
+ * @param arena 	The arena in which memory will be allocated.
+ * @param size 		The size of one object.
+ * @param alignment 	The alignment of each object, a power of 2.
+ * @param count 	The number of objects.
+ * @param out 		Receives the address of each object, or 0.
+ * @param flags 	Flags that modify allocation behavior, see arena_alloc.
+ *
+ * @return 	The first object, or 0 on failure.
+ */
+GLAD_DEF void* arena_alloc_array(arena* arena, ptrdiff_t size, ptrdiff_t alignment, ptrdiff_t count, void** out, int flags)
+{
+	if (size <= 0 || count <= 0 || alignment <= 0 || alignment & (alignment - 1))
+		return 0;
+	ptrdiff_t stride = ROUND_UP(size, alignment);
+	if (stride < size || stride > PTRDIFF_MAX / count)
+		return 0;
+
+	char* base = (char*)arena_alloc(arena, stride * count, alignment, flags);
+	if (!base)
+		return 0;
+	if (out) {
+		for (ptrdiff_t i = 0; i < count; ++i)
+			out[i] = base + i * stride;
+	}
+	GLAD_STAT(arena_stats_add(arena, count - 1, (size - stride) * count, 0));
+	return base;
+}
+
+/** 
+ * @brief	Allocates a region inside a registered buffer.
+ *
+ * @details
+ * 		Same as arena_alloc, for arenas whose cache was set up by 
+ * 		cache_init_buffers, and also returns the buffer index to pass to
+ * 		fixed-buffer I/O. A receive that comes back short can give the
+ * 		rest back with arena_extend.
+ *
+ * @param arena 	The arena in which memory will be allocated.
+ * @param num_bytes 	Number of bytes to allocate, at most a buffer.
+ * @param alignment 	Alignment of the returned region, must be a power of 2.
+ * @param index 	Set to the index of the buffer in cc_iovecs.
+ * @param flags 	Flags that modify allocation behavior, see arena_alloc.
+ *
+ * @return 	The region, or 0 if the allocation fails or the arena's cache
+ * 		holds no registered buffers.
+ */
+GLAD_DEF void* arena_alloc_fixed(arena* arena, ptrdiff_t num_bytes, ptrdiff_t alignment, int* index, int flags)
+{
+	if (!arena || !index || !arena->ar_cache || !arena->ar_cache->cc_buffers)
+		return 0;
+
+	void* ptr = arena_alloc(arena, num_bytes, alignment, flags);
+	*index = ptr ? cache_buffer_index(arena->ar_cache, ptr) : -1;
+	return *index < 0 ? 0 : ptr;
+}
+
+/** 
+ * @brief	Tells whether ptr points into one of the arena's chunks.
+ *
+ * @details
+ * 		Any byte of a chunk's data counts, used or not. Chunks are looked 
+ * 		up by binary search in ar_ranges, and an arena of a single chunk,
+ * 		such as a `RESERVE` or file-backed one, is a single comparison. 
+ * 		Not safe against concurrent allocation from the same arena.
+ *
+ * @param arena The arena.
+ * @param ptr 	The pointer to look up.
+ *
+ * @return 	1 if ptr lies in the arena, 0 otherwise.
+ */
+GLAD_DEF int arena_contains(const arena* arena, const void* ptr)
+{
+	if (!arena || !ptr || !arena->ar_head)
+		return 0;
+
+	uintptr_t addr = (uintptr_t)ptr;
+	if (arena->ar_head == arena->ar_tail)
+		return addr - (uintptr_t)arena->ar_head->ch_data < (uintptr_t)arena->ar_head->ch_size;
+
+	if (arena->ar_range_count < 0) {
+		for (chunk* cursor = arena->ar_head; cursor; cursor = cursor->ch_next) {
+			if (addr - (uintptr_t)cursor->ch_data < (uintptr_t)cursor->ch_size)
+				return 1;
+		}
+		return 0;
+	}
+
+	/* the last range starting at or below addr is the only candidate */
+	ptrdiff_t lo = 0, hi = arena->ar_range_count;
+	while (lo < hi) {
+		ptrdiff_t mid = lo + (hi - lo) / 2;
+		if (arena->ar_ranges[mid].rg_start <= addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo > 0 && addr < arena->ar_ranges[lo - 1].rg_end;
+}
+
+#ifdef GLAD_STATS
+/** 
+ * @brief	Gets the arena's allocation counters.
+ *
+ * @details
+ * 		The counters are kept up to date as the arena is used, so this
+ * 		does not walk the chunk list. st_allocs, st_failed, st_requested,
+ * 		st_padding and st_peak accumulate over the arena's lifetime; the
+ * 		rest describe what it holds right now.
+ *
+ * @param arena The arena to query.
+ *
+ * @return 	A copy of the counters, zeroed for a null arena.
+ */
+GLAD_DEF arena_stats arena_get_stats(const arena* arena)
+{
+	arena_stats stats;
+	memset(&stats, 0, sizeof stats);
+	if (arena) {
+		stats = arena->ar_stats;
+		stats.st_used = arena_get_size(arena);
+		stats.st_mapped = arena_get_mapped(arena);
+	}
+	return stats;
+}
+
+/** 
+ * @brief	Writes the arena's counters to out as one line of key=value pairs.
+ *
+ * @param arena The arena to dump.
+ * @param out 	The stream to write to.
+ */
+GLAD_DEF void arena_stats_dump(const arena* arena, FILE* out)
+{
+	arena_stats stats = arena_get_stats(arena);
+	fprintf(out, "allocs=%td failed=%td requested=%td padding=%td used=%td peak=%td chunks=%td mapped=%td\n",
+			stats.st_allocs, stats.st_failed, stats.st_requested, stats.st_padding,
+			stats.st_used, stats.st_peak, stats.st_chunks, stats.st_mapped);
+}
+#endif
+
+
+/** 
+ * @brief	Pushes the buffer onto the arena.
+ * 
+ * @details
+ * 		Buffers of GLAD_STREAM_SIZE bytes or more are copied with glad_copy,
+ * 		past the cache.
+ *
+ * @param arena The arena to which data will be pushed.
+ * @param data 	Pointer to the data buffer to push onto the arena.
+ * @param size 	Number of bytes in the data buffer.
+ * @param flags Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory.
+ *
+ * @return 	A pointer to the start of the newly allocated region.
+ */
+GLAD_DEF void* arena_push(arena* arena, void* data, ptrdiff_t size, ptrdiff_t alignment, int flags)
+{
+	if (!arena || !data) 
+		return 0;
+
+	/* the copy overwrites the region anyway, so never zero it first */
+	void* start_addr = arena_alloc(arena, size, alignment, flags & ~ZEROMEM);
+	if (!start_addr) return 0;
+	glad_copy(start_addr, data, size);
+	return start_addr;
+}
+
+/** 
+ * @brief	Registers fn(object) to run when the arena lets go of its memory.
+ *
+ * @details
+ * 		The record is allocated in the arena itself and linked into 
+ * 		ar_finalizers, so registering costs no heap allocation. arena_reset,
+ * 		arena_clear and arena_free run every finalizer, and arena_rewind
+ * 		those registered after the savepoint, last registered first and
+ * 		before the memory is touched. Finalizers must not allocate from,
+ * 		reset or free the arena. arena_copy does not carry them over.
+ *
+ * @param arena 	The arena whose lifetime object is tied to.
+ * @param fn 		The finalizer.
+ * @param object 	Passed to fn: an allocation of the arena, or anything else.
+ *
+ * @return 	1 on success, 0 if the record can't be allocated.
+ */
+GLAD_DEF int arena_on_free(arena* arena, void (*fn)(void*), void* object)
+{
+	if (!arena || !fn)
+		return 0;
+
+	arena_finalizer* node = (arena_finalizer*)arena_alloc(arena, sizeof *node, alignof(arena_finalizer), SOFTFAIL);
+	if (!node)
+		return 0;
+	node->fz_next = arena->ar_finalizers;
+	node->fz_fn = fn;
+	node->fz_object = object;
+	arena->ar_finalizers = node;
+	return 1;
+}
+
+/** 
+ * @brief	Allocates an object and registers fn to finalize it, see arena_on_free.
+ *
+ * @param arena 	The arena in which memory will be allocated.
+ * @param num_bytes 	Number of bytes to allocate.
+ * @param alignment 	Alignment of the returned region, must be a power of 2.
+ * @param fn 		Called with the object when the arena lets go of it.
+ * @param flags 	Flags that modify allocation behavior, see arena_alloc.
+ *
+ * @return 	The object, or 0 if either allocation fails.
+ */
+GLAD_DEF void* arena_alloc_finalized(arena* arena, ptrdiff_t num_bytes, ptrdiff_t alignment, void (*fn)(void*), int flags)
+{
+	if (!arena || !fn || num_bytes <= 0 || alignment <= 0 || alignment & (alignment - 1))
+		// alignment must be non-zero and a power of 2, as for arena_alloc
+		return 0;
+
+	/* one region for record and object, so that it is all or nothing */
+	ptrdiff_t offset = ROUND_UP((ptrdiff_t)sizeof(arena_finalizer), alignment);
+	ptrdiff_t align = alignment > (ptrdiff_t)alignof(arena_finalizer) ? alignment : (ptrdiff_t)alignof(arena_finalizer);
+	if (offset > PTRDIFF_MAX - num_bytes)
+		return 0;
+	char* start = (char*)arena_alloc(arena, offset + num_bytes, align, flags & ~ZEROMEM);
+	if (!start)
+		return 0;
+	if (flags & ZEROMEM)
+		memset(start + offset, 0, num_bytes);
+
+	arena_finalizer* node = (arena_finalizer*)start;
+	node->fz_next = arena->ar_finalizers;
+	node->fz_fn = fn;
+	node->fz_object = start + offset;
+	arena->ar_finalizers = node;
+	return start + offset;
+}
+
+/** 
+ * @brief	Runs the arena's finalizers, last registered first, down to stop.
+ *
+ * @param arena The arena.
+ * @param stop 	The first record to keep, 0 to run them all.
+ */
+GLAD_DEF void arena_run_finalizers(arena* arena, arena_finalizer* stop)
+{
+	while (arena->ar_finalizers && arena->ar_finalizers != stop) {
+		arena_finalizer* node = arena->ar_finalizers;
+		arena->ar_finalizers = node->fz_next;
+		node->fz_fn(node->fz_object);
+	}
+}
+
+#ifdef GLAD_DEBUG
+/** 
+ * @brief	Compares two possibly null strings for equality.
+ */
+GLAD_DEF int glad_streq(const char* a, const char* b)
+{
+	return a == b || (a && b && !strcmp(a, b));
+}
+
+/** 
+ * @brief	Sets the tag recorded with later allocations made through the macros.
+ *
+ * @param arena The arena to tag.
+ * @param tag 	A string that outlives the arena, or 0 for none.
+ */
+GLAD_DEF void arena_set_tag(arena* arena, const char* tag)
+{
+	if (arena)
+		arena->ar_tag = tag;
+}
+
+/** 
+ * @brief	Adds an allocation to the arena's call site table.
+ *
+ * @details
+ * 		Allocations from the same file, line, type and tag share an entry.
+ * 		The table lives in malloc'd memory next to the arena, so recording
+ * 		does not change what the arena hands out. If the table cannot grow 
+ * 		the allocation is left out of the report.
+ *
+ * @param arena The arena the allocation was made in.
+ * @param file 	The file of the call site.
+ * @param line 	The line of the call site.
+ * @param type 	The name of the allocated type.
+ * @param size 	The number of bytes requested.
+ */
+GLAD_DEF void arena_record(arena* arena, const char* file, int line, const char* type, ptrdiff_t size)
+{
+	for (ptrdiff_t i = 0; i < arena->ar_site_count; ++i) {
+		arena_site* site = &arena->ar_sites[i];
+		if (site->as_line == line && glad_streq(site->as_file, file) 
+				&& glad_streq(site->as_type, type) && glad_streq(site->as_tag, arena->ar_tag)) {
+			site->as_count += 1;
+			site->as_bytes += size;
+			return;
+		}
+	}
+
+	if (arena->ar_site_count == arena->ar_site_cap) {
+		ptrdiff_t cap = arena->ar_site_cap ? 2 * arena->ar_site_cap : 16;
+		arena_site* sites = (arena_site*)realloc(arena->ar_sites, cap * sizeof *sites);
+		if (!sites)
+			return;
+		arena->ar_sites = sites;
+		arena->ar_site_cap = cap;
+	}
+
+	arena_site site = { file, line, type, arena->ar_tag, 1, size };
+	arena->ar_sites[arena->ar_site_count++] = site;
+}
+
+/** 
+ * @brief	arena_alloc that records its call site, used by glad_new in GLAD_DEBUG builds.
+ *
+ * @return 	A pointer to the start of the newly allocated region.
+ */
+GLAD_DEF void* arena_alloc_site(arena* arena, ptrdiff_t num_bytes, ptrdiff_t alignment, int flags, 
+		const char* file, int line, const char* type)
+{
+	void* start_addr = arena_alloc(arena, num_bytes, alignment, flags);
+	if (start_addr)
+		arena_record(arena, file, line, type, num_bytes);
+	return start_addr;
+}
+
+/** 
+ * @brief	arena_push that records its call site, used by glad_push in GLAD_DEBUG builds.
+ *
+ * @return 	A pointer to the start of the newly allocated region.
+ */
+GLAD_DEF void* arena_push_site(arena* arena, void* data, ptrdiff_t size, ptrdiff_t alignment, int flags,
+		const char* file, int line, const char* type)
+{
+	void* start_addr = arena_push(arena, data, size, alignment, flags);
+	if (start_addr)
+		arena_record(arena, file, line, type, size);
+	return start_addr;
+}
+
+/** 
+ * @brief	arena_alloc_array that records its call site, used by glad_new_n in GLAD_DEBUG builds.
+ *
+ * @return 	The first object, or 0 on failure.
+ */
+GLAD_DEF void* arena_alloc_array_site(arena* arena, ptrdiff_t size, ptrdiff_t alignment, ptrdiff_t count, void** out,
+		int flags, const char* file, int line, const char* type)
+{
+	void* start_addr = arena_alloc_array(arena, size, alignment, count, out, flags);
+	if (start_addr)
+		arena_record(arena, file, line, type, size * count);
+	return start_addr;
+}
+
+/** 
+ * @brief	arena_alloc_finalized that records the call site, for glad_new_fin.
+ */
+GLAD_DEF void* arena_alloc_finalized_site(arena* arena, ptrdiff_t num_bytes, ptrdiff_t alignment, void (*fn)(void*),
+		int flags, const char* file, int line, const char* type)
+{
+	void* start_addr = arena_alloc_finalized(arena, num_bytes, alignment, fn, flags);
+	if (start_addr)
+		arena_record(arena, file, line, type, num_bytes);
+	return start_addr;
+}
+
+/** 
+ * @brief	Orders call sites by bytes allocated, largest first.
+ */
+GLAD_DEF int arena_site_cmp(const void* a, const void* b)
+{
+	ptrdiff_t x = ((const arena_site*)a)->as_bytes;
+	ptrdiff_t y = ((const arena_site*)b)->as_bytes;
+	return (x < y) - (x > y);
+}
+
+/** 
+ * @brief	Writes the bytes allocated per call site to out, largest first.
+ *
+ * @details
+ * 		Covers everything allocated through glad_new and glad_push since
+ * 		the arena was created, resets included. Sorts the table in place.
+ * 		Call it before arena_free, which drops the table.
+ *
+ * @param arena The arena to report on.
+ * @param out 	The stream to write to.
+ */
+GLAD_DEF void arena_report(arena* arena, FILE* out)
+{
+	if (!arena)
+		return;
+
+	if (arena->ar_site_count > 1)
+		qsort(arena->ar_sites, arena->ar_site_count, sizeof *arena->ar_sites, arena_site_cmp);
+	for (ptrdiff_t i = 0; i < arena->ar_site_count; ++i) {
+		const arena_site* site = &arena->ar_sites[i];
+		fprintf(out, "%12td bytes %8td allocs  %s:%d  %s%s%s\n", 
+				site->as_bytes, site->as_count, site->as_file, site->as_line, site->as_type,
+				site->as_tag ? " " : "", site->as_tag ? site->as_tag : "");
+	}
+}
+#endif
+
+/** 
+ * @brief	Resizes the most recent allocation of the arena in place.
+ *
+ * @details
+ * 		Only works when ptr is the last region carved out of the current 
+ * 		chunk and size and alignment match the arena_alloc call that 
+ * 		returned it. Shrinking always succeeds in that case, growing as 
+ * 		long as the current chunk has room.
+ *
+ * @param arena 	The arena ptr was allocated in.
+ * @param ptr 		The region to resize.
+ * @param old_size 	The size the region was allocated with.
+ * @param new_size 	The requested size.
+ * @param alignment 	The alignment the region was allocated with.
+ * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` to zero the added bytes.
+ *
+ * @return 	ptr if the region was resized, 0 otherwise.
+ */
+GLAD_DEF void* arena_extend(arena* arena, void* ptr, ptrdiff_t old_size, ptrdiff_t new_size, ptrdiff_t alignment, int flags)
+{
+	if (!arena || !ptr || old_size <= 0 || new_size <= 0 || alignment <= 0 || alignment & (alignment - 1))
+		return 0;
+
+	char* start = (char*)ptr;
+	ptrdiff_t old_alloc = ROUND_UP(old_size, alignment);
+	ptrdiff_t new_alloc = ROUND_UP(new_size, alignment);
+	if (new_alloc < new_size || start + old_alloc != arena->ar_ptr)
+		return 0;
+	if (arena->ar_end - start < new_alloc) {
+		chunk* curr = arena->ar_curr;
+		if (!chunk_commit(curr, (start - curr->ch_data) + new_alloc))
+			return 0;
+		arena->ar_end = &curr->ch_data[curr->ch_commit];
+	}
+
+	if (new_alloc < old_alloc) {
+		/* the bytes given back were handed out, so they are no longer known zero */
+		chunk* curr = arena->ar_curr;
+		if (arena->ar_ptr - curr->ch_data > curr->ch_dirty) {
+			curr->ch_dirty = arena->ar_ptr - curr->ch_data;
+			arena->ar_zero = arena->ar_ptr;
+		}
+	} else {
+		GLAD_UNPOISON(arena->ar_ptr, new_alloc - old_alloc);
+		if (flags & ZEROMEM) {
+			/* the padding after old_size belongs to the caller now, too */
+			memset(start + old_size, 0, old_alloc - old_size);
+			if (arena->ar_ptr < arena->ar_zero)
+				chunk_zero(arena->ar_curr, arena->ar_ptr, new_alloc - old_alloc);
+		}
+	}
+
+	GLAD_STAT(arena_stats_add(arena, 0, new_size - old_size, new_alloc - old_alloc));
+	arena->ar_ptr = start + new_alloc;
+	return ptr;
+}
+
+/** 
+ * @brief	Resizes an allocation, in place when possible.
+ *
+ * @details
+ * 		The last allocation of the current chunk is extended in place, 
+ * 		see arena_extend. Any other region is shrunk in place, or grown by
+ * 		allocating a new region and copying the old contents over; the old
+ * 		region stays in the arena until it is reset or freed.
+ *
+ * @param arena 	The arena ptr was allocated in.
+ * @param ptr 		The region to resize, or 0 to allocate a new one.
+ * @param old_size 	The size the region was allocated with.
+ * @param new_size 	The requested size.
+ * @param alignment 	The alignment the region was allocated with.
+ * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` to zero the added bytes.
+ *
+ * @return 	A pointer to the resized region, or 0 if the allocation fails.
+ */
+GLAD_DEF void* arena_realloc(arena* arena, void* ptr, ptrdiff_t old_size, ptrdiff_t new_size, ptrdiff_t alignment, int flags)
+{
+	if (!ptr || old_size <= 0)
+		return arena_alloc(arena, new_size, alignment, flags);
+
+	void* start_addr = arena_extend(arena, ptr, old_size, new_size, alignment, flags);
+	if (start_addr)
+		return start_addr;
+	if (new_size > 0 && new_size <= old_size)
+		return ptr;
+
+	start_addr = arena_alloc(arena, new_size, alignment, flags & ~ZEROMEM);
+	if (!start_addr)
+		return 0;
+	/* the caller reads and appends right away, so keep the copy in cache */
+	memcpy(start_addr, ptr, old_size);
+	if (flags & ZEROMEM)
+		memset((char*)start_addr + old_size, 0, new_size - old_size);
+	return start_addr;
+}
+
+/** 
+ * @brief	Orders relocations by old address.
+ */
+GLAD_DEF int arena_reloc_cmp(const void* a, const void* b)
+{
+	uintptr_t x = ((const arena_reloc*)a)->rl_old;
+	uintptr_t y = ((const arena_reloc*)b)->rl_old;
+	return (x > y) - (x < y);
+}
+
+/** 
+ * @brief	Translates a pointer from before arena_compact to where it points now.
+ *
+ * @details
+ * 		Pointers one past the end of a chunk's data move with it. Only 
+ * 		compares addresses, so the old memory does not need to exist.
+ *
+ * @param relocs 	The table filled by arena_compact.
+ * @param ptr 		A pointer into the arena from before the compaction.
+ *
+ * @return 	The moved pointer, or ptr if it did not point into the arena.
+ */
+GLAD_DEF void* arena_relocate(const arena_relocs* relocs, const void* ptr)
+{
+	uintptr_t addr = (uintptr_t)ptr;
+	ptrdiff_t lo = 0;
+	ptrdiff_t hi = relocs ? relocs->rs_count : 0;
+	/* find the last entry that starts at or below addr */
+	while (lo < hi) {
+		ptrdiff_t mid = lo + (hi - lo) / 2;
+		if (relocs->rs_entries[mid].rl_old <= addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo) {
+		const arena_reloc* entry = &relocs->rs_entries[lo - 1];
+		if (addr - entry->rl_old <= (uintptr_t)entry->rl_size)
+			return (void*)(addr + entry->rl_delta);
+	}
+	return (void*)ptr;
+}
+
+/** 
+ * @brief	arena_compact_parallel, with the copies queued for run, or done on 
+ * 		the spot without it.
+ */
+GLAD_DEF void* arena_compact_batched(arena* arena, arena_relocs* relocs, ptrdiff_t alignment, int flags,
+		const glad_executor* executor, glad_batch_run run)
+{
+	if (relocs) {
+		relocs->rs_entries = 0;
+		relocs->rs_count = 0;
+	}
+	if (!arena || !arena->ar_head || arena->ar_head->ch_flags & CHUNK_FILE)
+		return 0;	
+	if (alignment <= 0 || alignment & (alignment - 1))
+		return 0;
+
+	arena_sync(arena);
+	/* the finalizer records are moved along with the caller's data */
+	ptrdiff_t align = alignment;
+	if (arena->ar_finalizers && align < (ptrdiff_t)alignof(arena_finalizer))
+		align = alignof(arena_finalizer);
+	ptrdiff_t alloc_size = 0;
+	ptrdiff_t count = 0;
+	for (chunk* cursor = arena->ar_head; cursor; cursor = cursor->ch_next) {
+		if (!cursor->ch_offset)
+			continue;
+		alloc_size += align - 1 + cursor->ch_offset;
+		++count;
+	}
+
+	/* the finalizer list lives in the arena, so it needs the table too */
+	arena_reloc* entries = 0;
+	if ((relocs || arena->ar_finalizers) && count) {
+		entries = (arena_reloc*)malloc(count * sizeof *entries);
+		if (!entries)
+			return 0;
+	}
+	chunk* cropped = arena_new_chunk(arena, alloc_size > 0 ? alloc_size : 1,
+			flags | arena->ar_flags); 
+	if (cropped && !chunk_commit(cropped, alloc_size)) {
+		cache_free_chunk(arena->ar_cache, cropped);
+		cropped = 0;
+	}
+	if (!cropped) {
+		free(entries);
+		return 0;
+	}
+
+	glad_copy_batch batch;
+	memset(&batch, 0, sizeof batch);
+	ptrdiff_t curr_offset = 0;
+	count = 0;
+	for (chunk* cursor = arena->ar_head; cursor; cursor = cursor->ch_next) {
+		if (cursor->ch_offset) {
+			/* keep the data's address modulo align, whatever ch_data's */
+			curr_offset += ((uintptr_t)cursor->ch_data - (uintptr_t)&cropped->ch_data[curr_offset]) & (align - 1);
+			copy_batch_add(run ? &batch : 0, &cropped->ch_data[curr_offset],
+					cursor->ch_data,
+					sizeof(char) * cursor->ch_offset);
+			if (entries) {
+				arena_reloc* entry = &entries[count++];
+				entry->rl_old = (uintptr_t)cursor->ch_data;
+				entry->rl_size = cursor->ch_offset;
+				entry->rl_delta = (ptrdiff_t)((uintptr_t)&cropped->ch_data[curr_offset] - entry->rl_old);
+			}
+			curr_offset += cursor->ch_offset;
+		}
+	}
+	if (run)
+		run(&batch, executor);
+
+	chunk* cursor = arena->ar_head;
+	while (cursor) {
+		chunk* prev = cursor;
+		cursor = cursor->ch_next;	
+		cache_free_chunk(arena->ar_cache, prev);
+	}
+		
+	cropped->ch_offset = curr_offset;
+	arena->ar_head = cropped;
+	arena->ar_tail = arena->ar_head;
+	arena_set_current(arena, cropped);
+	arena_recount(arena);
+
+	arena_relocs table;
+	table.rs_entries = entries;
+	table.rs_count = count;
+	if (entries)
+		qsort(entries, count, sizeof *entries, arena_reloc_cmp);
+	arena->ar_finalizers = (arena_finalizer*)arena_relocate(&table, arena->ar_finalizers);
+	for (arena_finalizer* node = arena->ar_finalizers; node; node = node->fz_next) {
+		node->fz_next = (arena_finalizer*)arena_relocate(&table, node->fz_next);
+		node->fz_object = arena_relocate(&table, node->fz_object);
+	}
+
+	if (relocs)
+		*relocs = table;
+	else
+		free(entries);
+	return cropped->ch_data;
+}
+
+/** 
+ * @brief	Moves the contents of every chunk into a single new chunk.
+ * 
+ * @details
+ * 		Copies over only the used part of each chunk and frees the old
+ * 		ones. Each chunk's data is padded until its address modulo 
+ * 		alignment is what it was, so anything allocated with that 
+ * 		alignment or less stays aligned. With alignment 1, such as for an
+ * 		array of bytes pushed across chunks, the chunks come out as one 
+ * 		contiguous block. Every pointer into the
+ * 		arena moves, pool free lists included; with relocs set, the table
+ * 		needed to translate them is filled in. File-backed arenas are a
+ * 		single chunk already and are left alone.
+ *
+ * 		With an executor the copies are split by chunk, and huge chunks 
+ * 		into DEFAULT_COPY_SLICE slices, and run in parallel; every
+ * 		destination offset is known before the first byte moves.
+ *
+ * @param arena 	The arena to compact.
+ * @param relocs 	Receives one entry per moved chunk, or 0.
+ * @param alignment The largest alignment anything still in use was allocated 
+ * 			with, must be a power of 2.
+ * @param flags 	Flags that modify behavior, e.g., `ZEROMEM` for zeroing memory.
+ * @param executor 	Runs the copies, see glad_run. 0 copies on the calling thread.
+ *
+ * @return 	A pointer to the start of the new chunk's data, or 0 if the arena
+ * 		is empty or file-backed, alignment is invalid, or the allocation 
+ * 		fails.
+ */
+GLAD_DEF void* arena_compact_parallel(arena* arena, arena_relocs* relocs, ptrdiff_t alignment, int flags,
+		const glad_executor* executor)
+{
+	return arena_compact_batched(arena, relocs, alignment, flags, executor, executor ? copy_batch_run : 0);
+}
+
+/** 
+ * @brief	Moves the contents of every chunk into a single new chunk.
+ * 
+ * @details
+ * 		arena_compact_parallel on the calling thread.
+ */
+GLAD_DEF void* arena_compact(arena* arena, arena_relocs* relocs, ptrdiff_t alignment, int flags)
+{
+	return arena_compact_batched(arena, relocs, alignment, flags, 0, 0);
+}
+
+/** 
+ * @brief	Frees the table filled by arena_compact.
+ */
+GLAD_DEF void arena_relocs_free(arena_relocs* relocs)
+{
+	if (!relocs)
+		return;
+	free(relocs->rs_entries);
+	relocs->rs_entries = 0;
+	relocs->rs_count = 0;
+}
+
+/** 
+ * @brief	Crops the arena to its final in-use element and coalesces the chunks.
+ * 
+ * @details
+ * 		arena_compact at DEFAULT_COMPACT_ALIGN without the relocation 
+ * 		table, so data keeps its alignment up to that but every pointer
+ * 		into the arena is invalidated. Chunks whose data is aligned alike
+ * 		and whose used bytes are a multiple of it are packed back to back.
+ *
+ * @param arena The arena to crop and coalesce.
+ * @param flags Flags that modify behavior, e.g., `ZEROMEM` for zeroing memory.
+ *
+ * @return 	A pointer to the start of the newly allocated region.
+ */
+GLAD_DEF void* arena_crop_and_coalesce(arena* arena, int flags)
+{
+	return arena_compact(arena, 0, DEFAULT_COMPACT_ALIGN, flags);
+}
+
+/** 
+ * @brief 	Clears the given arena without freeing the memory.
+ *
+ * @details
+ *		Marks the chunks as empty again so that they may be used, and 
+ *		zeroes what was handed out. Only the bytes below each chunk's
+ *		max(ch_offset, ch_dirty) can be non-zero, so that is all that 
+ *		gets written. `DISCARD` arenas discard the pages of chunks with at
+ *		least DEFAULT_DISCARD_SIZE used bytes instead, which also gives
+ *		them back to the kernel until they are used again.
+ *
+ * @param arena The arena to clear.
+ */
+GLAD_DEF void arena_clear(arena* arena)
+{
+	if (!arena)
+		return;
+
+	arena_run_finalizers(arena, 0);
+
+#ifdef GLAD_GUARD
+	if (arena->ar_guard) {
+		arena_release_guarded(arena);
+		return;
+	}
+#endif
+
+	arena_sync(arena);
+	chunk* cursor = arena->ar_head;
+	while (cursor) {
+		ptrdiff_t used = cursor->ch_offset > cursor->ch_dirty ? cursor->ch_offset : cursor->ch_dirty;
+		if (used > cursor->ch_commit)
+			used = cursor->ch_commit;
+		GLAD_UNPOISON(cursor->ch_data, used);
+		/* discarded file pages read back the file, not zeroes */
+		if ((arena->ar_flags & DISCARD) && used >= DEFAULT_DISCARD_SIZE
+				&& !(cursor->ch_flags & (CHUNK_MEMFD | CHUNK_FROZEN | CHUNK_FILE | CHUNK_MAPPED | CHUNK_BUFFER)))
+			chunk_discard(cursor, used);
+		else
+			memset(cursor->ch_data, 0, used);
+#ifdef GLAD_ASAN
+		/* the fill pattern would undo the zeroing, so only ASan poisons here */
+		GLAD_POISON(cursor->ch_data, used);
+#endif
+		cursor->ch_offset = 0;
+		cursor->ch_dirty = 0;
+		cursor = cursor->ch_next;	
+	}
+	arena_set_current(arena, arena->ar_head);
+	arena->ar_used = 0;
+}
+
+/** 
+ * @brief 	Marks whole arena as unallocated.
+ *
+ * @details
+ * 		Does not set the associated memory. Use with care. Later `ZEROMEM`
+ * 		allocations zero whatever part of the reused memory they receive.
+ *
+ * @param arena The arena to reset.
+ */
+GLAD_DEF void arena_reset(arena* arena)
+{
+	if (!arena)
+		return;
+
+	arena_run_finalizers(arena, 0);
+
+#ifdef GLAD_GUARD
+	if (arena->ar_guard) {
+		arena_release_guarded(arena);
+		return;
+	}
+#endif
+
+	arena_sync(arena);
+	chunk* cursor = arena->ar_head;
+	while (cursor) {
+		if (cursor->ch_offset > cursor->ch_dirty)
+			cursor->ch_dirty = cursor->ch_offset;
+		GLAD_POISON(cursor->ch_data, cursor->ch_offset);
+		cursor->ch_offset = 0;
+		cursor = cursor->ch_next;	
+	}
+	arena_set_current(arena, arena->ar_head);
+	arena->ar_used = 0;
+}
+
+/** 
+ * @brief 	Records the current position of the arena.
+ *
+ * @details
+ * 		Everything allocated after the mark can be given back at once with 
+ * 		arena_rewind, which makes the arena usable as a stack-like scratch
+ * 		allocator. Marks can be nested as long as they are rewound in 
+ * 		reverse order.
+ *
+ * @param arena The arena to mark.
+ *
+ * @return 	The savepoint. It is invalidated by arena_reset, arena_clear, 
+ * 		arena_free, arena_crop_and_coalesce and by rewinding past it.
+ */
+GLAD_DEF arena_savepoint arena_mark(arena* arena)
+{
+	arena_savepoint savepoint;
+	memset(&savepoint, 0, sizeof savepoint);
+	if (!arena || !arena->ar_curr)
+		return savepoint;
+
+	savepoint.sp_finalizers = arena->ar_finalizers;
+
+	savepoint.sp_curr = arena->ar_curr;
+	savepoint.sp_offset = arena->ar_ptr - arena->ar_curr->ch_data;
+	savepoint.sp_tail = arena->ar_tail;
+	return savepoint;
+}
+
+/** 
+ * @brief 	Gives back everything allocated since the savepoint was taken.
+ *
+ * @details
+ * 		Chunks added to the arena after the mark are released to the 
+ * 		arena's chunk_cache, or unmapped if it has none. Chunks that 
+ * 		already existed are kept for reuse. Does not set the associated
+ * 		memory, and does not undo `FIRSTFIT` allocations made in chunks 
+ * 		before the marked one.
+ *
+ * @param arena 	The arena to rewind.
+ * @param savepoint 	A savepoint returned by arena_mark on this arena.
+ */
+GLAD_DEF void arena_rewind(arena* arena, arena_savepoint savepoint)
+{
+	if (!arena)
+		return;
+
+	arena_run_finalizers(arena, savepoint.sp_finalizers);
+	arena_sync(arena);
+
+	/* release the chunks mapped since the mark */
+	chunk* cursor = savepoint.sp_tail ? savepoint.sp_tail->ch_next : arena->ar_head;
+	while (cursor) {
+		chunk* prev = cursor;
+		cursor = cursor->ch_next;
+		cache_free_chunk(arena->ar_cache, prev);
+	}
+	if (savepoint.sp_tail)
+		savepoint.sp_tail->ch_next = 0;
+	else
+		arena->ar_head = 0;
+	arena->ar_tail = savepoint.sp_tail;
+
+	if (!savepoint.sp_curr) {
+		arena_set_current(arena, arena->ar_head);
+		arena_recount(arena);
+			return;
+	}
+
+	/* spare chunks that were moved into since the mark are empty again */
+	for (cursor = savepoint.sp_curr; cursor; cursor = cursor->ch_next) {
+		if (cursor->ch_offset > cursor->ch_dirty)
+			cursor->ch_dirty = cursor->ch_offset;
+		ptrdiff_t kept = cursor == savepoint.sp_curr ? savepoint.sp_offset : 0;
+		if (cursor->ch_offset > kept)
+			GLAD_POISON(&cursor->ch_data[kept], cursor->ch_offset - kept);
+		cursor->ch_offset = 0;
+		if (cursor == savepoint.sp_tail)
+			break;
+	}
+	savepoint.sp_curr->ch_offset = savepoint.sp_offset;
+	arena_set_current(arena, savepoint.sp_curr);
+	arena_recount(arena);
+}
+
+/** 
+ * @brief 	Gives committed but unused pages of `RESERVE` chunks back to the kernel.
+ *
+ * @details
+ * 		Pages past each chunk's ch_offset are discarded with 
+ * 		madvise(MADV_DONTNEED) and made PROT_NONE again, so they stop counting
+ * 		against RSS and the commit limit. Meant to be called after 
+ * 		arena_reset or arena_rewind. Other chunks are left alone.
+ *
+ * @param arena The arena to decommit.
+ */
+GLAD_DEF void arena_decommit(arena* arena)
+{
+	if (!arena)
+		return;
+
+	arena_sync(arena);
+	for (chunk* cursor = arena->ar_head; cursor; cursor = cursor->ch_next) {
+		/* discarded file pages read back the file, not zeroes */
+		if (!(cursor->ch_flags & CHUNK_RESERVE) || cursor->ch_flags & (CHUNK_MEMFD | CHUNK_FROZEN | CHUNK_FILE))
+			continue;
+
+		ptrdiff_t step = cursor->ch_flags & CHUNK_THP ? GLAD_HUGE_PAGE_SIZE : DEFAULT_COMMIT_SIZE;
+		ptrdiff_t keep = ROUND_UP((ptrdiff_t)CHUNK_ALLOC_SIZE(cursor->ch_offset), step);
+		ptrdiff_t committed = CHUNK_ALLOC_SIZE(cursor->ch_commit);
+		if (keep >= committed)
+			continue;
+
+		char* start = (char*)cursor + keep;
+		GLAD_UNPOISON(start, committed - keep);
+		if (glad_discard(start, committed - keep) 
+				|| mprotect(start, committed - keep, PROT_NONE))
+			continue;
+		cursor->ch_commit = keep - sizeof(chunk);
+		/* discarded pages come back zero-filled */
+		if (cursor->ch_dirty > cursor->ch_commit)
+			cursor->ch_dirty = cursor->ch_commit;
+	}
+	arena_set_current(arena, arena->ar_curr);
+}
+
+/** 
+ * @brief  Frees the given arena.
+ *
+ * @details
+ * 		Chunks go back to the arena's chunk_cache when it has one. 
+ * 		`ZEROMEM` leaves the chunk of a file-backed arena alone, so the
+ * 		image stays intact on disk.
+ *
+ * @param arena The arena to free.
+ * @param flags Flags that modify free behavior, e.g., `ZEROMEM` for zeroing memory.
+ */
+GLAD_DEF void arena_free(arena* arena, int flags)
+{
+	if (!arena)
+		return;
+
+	arena_run_finalizers(arena, 0);
+	arena_sync(arena);
+	chunk* cursor = arena->ar_head;
+	while (cursor) {
+		/* a file chunk keeps its contents for the next arena_file_open */
+		if (flags & ZEROMEM && !(cursor->ch_flags & CHUNK_FILE)) {
+			/* memory past the high-water mark was never written */
+			ptrdiff_t used = cursor->ch_offset > cursor->ch_dirty ? cursor->ch_offset : cursor->ch_dirty;
+			GLAD_UNPOISON(cursor->ch_data, used);
+			memset(cursor->ch_data, 0, used);
+			cursor->ch_offset = 0;
+			cursor->ch_dirty = 0;
+		}
+		chunk* prev = cursor;
+		cursor = cursor->ch_next;	
+		cache_free_chunk(arena->ar_cache, prev);
+	}
+	arena->ar_head = 0;
+	arena->ar_tail = 0;
+	arena->ar_next_chunk = 0;
+	arena_set_current(arena, 0);
+	arena_recount(arena);
+	free(arena->ar_ranges);
+	arena->ar_ranges = 0;
+	arena->ar_range_count = 0;
+	arena->ar_range_cap = 0;
+#ifdef GLAD_DEBUG
+	free(arena->ar_sites);
+	arena->ar_sites = 0;
+	arena->ar_site_count = 0;
+	arena->ar_site_cap = 0;
+#endif
+}	
+
+#ifdef GLAD_MEMFD
+/** 
+ * @brief	Makes a copy-on-write copy of a memfd chunk.
+ *
+ * @details
+ * 		The source is remapped MAP_PRIVATE first, so that neither its
+ * 		writes nor the copy's reach the memfd any more, and the memfd keeps
+ * 		the contents at the time of the snapshot. Both chunks then share
+ * 		the pages until one of them writes to a page. Both end up 
+ * 		CHUNK_FROZEN, and later copies of them go through memcpy. The 
+ * 		source's addresses do not change.
+ *
+ * @param ch 	A CHUNK_MEMFD chunk, with ch_offset in sync.
+ *
+ * @return 	The copy, or 0 if the mappings fail. ch may be frozen even then.
+ */
+GLAD_DEF chunk* chunk_snapshot(chunk* ch)
+{
+	ptrdiff_t length = CHUNK_ALLOC_SIZE(ch->ch_size);
+	ptrdiff_t committed = CHUNK_ALLOC_SIZE(ch->ch_commit);
+	int map_flags = 0;
+#ifdef MAP_NORESERVE
+	if (ch->ch_flags & CHUNK_RESERVE)
+		map_flags = MAP_NORESERVE;
+#endif
+#ifdef GLAD_GUARD
+	/* the part past the end of the file stays PROT_NONE and guards both */
+	if (ch->ch_flags & CHUNK_GUARD) {
+		ptrdiff_t page = sysconf(_SC_PAGESIZE);
+		length = ROUND_UP(length, page) + page;
+	}
+#endif
+
+	int fd = ch->ch_fd;
+	if (glad_mmap_private(ch, fd, committed, length, map_flags) == MAP_FAILED)
+		return 0;
+	ch->ch_flags = (ch->ch_flags & ~CHUNK_MEMFD) | CHUNK_FROZEN;
+
+	/* the mappings keep the memfd open */
+	chunk* copy = (chunk*)glad_mmap_private(0, fd, committed, length, map_flags);
+	close(fd);
+	if (copy == (chunk*)MAP_FAILED)
+		return 0;
+
+	/* the header was read back from the memfd, offsets included */
+	copy->ch_next = 0;
+	copy->ch_flags = ch->ch_flags;
+	return copy;
+}
+#endif
+
+/** 
+ * @brief	Copies a single chunk for arena_copy.
+ *
+ * @param copy_dst 	The arena the copy is for.
+ * @param src 		The chunk to copy, with ch_offset in sync.
+ * @param flags 	The flags passed to arena_copy.
+ * @param batch 	Where to queue the copy of the data, or 0 to copy it now.
+ *
+ * @return 	The copy, or 0 if the allocation fails.
+ */
+GLAD_DEF chunk* arena_copy_chunk(arena* copy_dst, chunk* src, int flags, glad_copy_batch* batch)
+{
+#ifdef GLAD_MEMFD
+	if (flags & SNAPSHOT && src->ch_flags & CHUNK_MEMFD) {
+		chunk* copy = chunk_snapshot(src);
+		if (copy)
+			return copy;
+	}
+#endif
+
+	chunk* copy = arena_new_chunk(copy_dst, src->ch_size,
+			(flags & ~SNAPSHOT) | copy_dst->ar_flags | (src->ch_flags & CHUNK_RESERVE ? RESERVE : 0));
+	if (copy && !chunk_commit(copy, src->ch_offset)) {
+		cache_free_chunk(copy_dst->ar_cache, copy);
+		copy = 0;
+	}
+	if (!copy)
+		return 0;
+
+	copy->ch_offset = src->ch_offset;
+	copy_batch_add(batch, copy->ch_data, src->ch_data, sizeof(char) * src->ch_offset);
+	return copy;
+}
+
+/** 
+ * @brief	arena_copy_parallel, with the copies queued for run, or done on 
+ * 		the spot without it.
+ */
+GLAD_DEF void arena_copy_batched(arena *GLAD_RESTRICT copy_dst, const arena *GLAD_RESTRICT copy_src, int flags,
+		const glad_executor* executor, glad_batch_run run)
+{
+	if (!copy_dst || !copy_src) 
+		return;
+	if (!copy_src->ar_head || !copy_src->ar_tail)
+		return;
+	arena_sync(copy_src);
+	glad_copy_batch batch;
+	memset(&batch, 0, sizeof batch);
+	glad_copy_batch* pending = run ? &batch : 0;
+	
+	/* allocate the head of our new list */	
+	chunk *dst_head = arena_copy_chunk(copy_dst, copy_src->ar_head, flags, pending);
+	if (!dst_head)
+		return;
+	copy_dst->ar_head = dst_head;
+	copy_dst->ar_tail = copy_dst->ar_head;
+	arena_set_current(copy_dst, dst_head);
+
 	chunk *src_cursor = copy_src->ar_head->ch_next;
 	chunk *dst_cursor = dst_head;
 	while (src_cursor) {
-		chunk *new_chunk = alloc_chunk(src_cursor->ch_size, flags);
+		chunk *new_chunk = arena_copy_chunk(copy_dst, src_cursor, flags, pending);
 		/* cleanup the new area if we ever fail to allocate */
 		if (!new_chunk) {
+		    free(batch.cb_jobs);
 		    arena_free(copy_dst, flags);
 		    return;
 		}
-		
-		new_chunk->ch_offset = src_cursor->ch_offset;
-		new_chunk->ch_size = src_cursor->ch_size;
-		memcpy(new_chunk->ch_data,
-				src_cursor->ch_data,
-				sizeof(char) * src_cursor->ch_offset);
-		
-		dst_cursor->ch_next = new_chunk;
+		
+		dst_cursor->ch_next = new_chunk;
+
+		copy_dst->ar_tail = new_chunk;
+		/* mirror the source's current chunk so spare chunks stay spare */
+		if (src_cursor == copy_src->ar_curr)
+			arena_set_current(copy_dst, new_chunk);
+		dst_cursor = new_chunk;
+		src_cursor = src_cursor->ch_next;
+	}
+	if (run)
+		run(&batch, executor);
+	arena_recount(copy_dst);
+}
+
+/** 
+ * @brief	Copies arena copy_src to copy_dst.
+ * 
+ * @details
+ * 		Any allocation failure results in cleanup. With `SNAPSHOT` the
+ * 		memfd chunks of a `SNAPSHOT` arena are mapped copy-on-write instead
+ * 		of copied, so only the pages that either arena writes to later get
+ * 		duplicated. Each chunk can be snapshotted once; after that, and for
+ * 		other chunks, the copy falls back to memcpy.
+ *
+ * 		copy_src is const for its contents and addresses only. A `SNAPSHOT`
+ * 		copy remaps the source's memfd chunks in place and marks them 
+ * 		CHUNK_FROZEN, and every copy syncs its bump pointer, so the source
+ * 		must not be in use by another thread during the call.
+ * 
+ * 		With an executor the chunks are mapped first, and the copies are
+ * 		then split by chunk, and huge chunks into DEFAULT_COPY_SLICE 
+ * 		slices, and run in parallel.
+ * 
+ * @param copy_dst 	The destination arena to which data will be copied.
+ * @param copy_src 	The source arena from which data will be copied.
+ * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory,
+ * 			`SNAPSHOT` to copy on write.
+ * @param executor 	Runs the copies, see glad_run. 0 copies on the calling thread.
+ */
+GLAD_DEF void arena_copy_parallel(arena *GLAD_RESTRICT copy_dst, const arena *GLAD_RESTRICT copy_src, int flags,
+		const glad_executor* executor)
+{
+	arena_copy_batched(copy_dst, copy_src, flags, executor, executor ? copy_batch_run : 0);
+}
+
+/** 
+ * @brief	Copies arena copy_src to copy_dst.
+ * 
+ * @details
+ * 		arena_copy_parallel on the calling thread. With `SNAPSHOT` the 
+ * 		source's chunks are remapped, see there.
+ */
+GLAD_DEF void arena_copy(arena *GLAD_RESTRICT copy_dst, const arena *GLAD_RESTRICT copy_src, int flags)
+{
+	arena_copy_batched(copy_dst, copy_src, flags, 0, 0);
+}
+
+/** 
+ * @brief	Maps the image in fd for arena_file_open.
+ *
+ * @param arena 	The arena to hand the chunk to.
+ * @param fd 		The open file.
+ * @param writable 	Whether fd was opened for writing.
+ *
+ * @return 	1 on success, 0 with errno set on failure.
+ */
+GLAD_DEF int arena_file_map(arena* arena, int fd, int writable)
+{
+	ptrdiff_t page = sysconf(_SC_PAGESIZE);
+	ptrdiff_t header = sizeof(chunk);
+	arena_image image = { GLAD_IMAGE_MAGIC, GLAD_IMAGE_VERSION, sizeof(chunk), GLAD_IMAGE_OFFSET, 0, -1 };
+	struct stat st;
+	if (fstat(fd, &st))
+		return 0;
+
+	ptrdiff_t file_size = st.st_size;
+	if (!file_size && writable) {
+		file_size = GLAD_IMAGE_OFFSET + ROUND_UP(header, DEFAULT_COMMIT_SIZE);
+		if (ftruncate(fd, file_size) || pwrite(fd, &image, sizeof image, 0) != (ssize_t)sizeof image)
+			return 0;
+	} else if (pread(fd, &image, sizeof image, 0) != (ssize_t)sizeof image
+			|| image.im_magic != GLAD_IMAGE_MAGIC
+			|| image.im_version != GLAD_IMAGE_VERSION
+			|| image.im_header != sizeof(chunk)
+			|| image.im_offset != GLAD_IMAGE_OFFSET
+			|| GLAD_IMAGE_OFFSET % page
+			|| image.im_used < 0
+			|| file_size < GLAD_IMAGE_OFFSET + header + image.im_used) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	/* map whole pages of the file, growing it to match if it is ours */
+	ptrdiff_t committed = ROUND_UP(file_size - GLAD_IMAGE_OFFSET, page);
+	if (writable && GLAD_IMAGE_OFFSET + committed > file_size && ftruncate(fd, GLAD_IMAGE_OFFSET + committed))
+		return 0;
+	ptrdiff_t length = committed;
+	if (writable) {
+		ptrdiff_t reserve = arena->ar_reserve ? arena->ar_reserve : DEFAULT_RESERVE_SIZE;
+		length = ROUND_UP((ptrdiff_t)CHUNK_ALLOC_SIZE(reserve), page);
+		if (length < committed)
+			length = committed;
+	}
+
+	int map_flags = 0;
+#ifdef MAP_NORESERVE
+	map_flags = MAP_NORESERVE;
+#endif
+	char* base = (char*)glad_mmap(GLAD_IMAGE_OFFSET + length, PROT_NONE, map_flags);
+	if (base == (char*)MAP_FAILED)
+		return 0;
+	if (mmap(base, GLAD_IMAGE_OFFSET + committed, PROT_READ | PROT_WRITE,
+				(writable ? MAP_SHARED : MAP_PRIVATE) | MAP_FIXED, fd, 0) == MAP_FAILED) {
+		munmap(base, GLAD_IMAGE_OFFSET + length);
+		return 0;
+	}
+
+	/* the chunk header in the file belongs to whichever process has it open */
+	chunk* ch = (chunk*)(base + GLAD_IMAGE_OFFSET);
+	ch->ch_next = 0;
+	ch->ch_size = length - header;
+	ch->ch_commit = committed - header;
+	ch->ch_offset = image.im_used;
+	/* the file may hold anything past im_used */
+	ch->ch_dirty = ch->ch_commit;
+	ch->ch_flags = CHUNK_FILE | (writable ? CHUNK_RESERVE : 0);
+	ch->ch_fd = fd;
+
+	arena->ar_head = ch;
+	arena->ar_tail = ch;
+	arena_set_current(arena, ch);
+	arena_recount(arena);
+	return 1;
+}
+
+/** 
+ * @brief	Opens the file at path as a file-backed arena.
+ *
+ * @details
+ * 		The arena is a single chunk that is a view of the file, after
+ * 		an arena_image header. A new or empty file gets a fresh header.
+ * 		For an existing image the bytes allocated before it was closed
+ * 		are still there, and allocation continues after them.
+ *
+ * 		With O_RDWR the chunk reserves ar_reserve bytes of address space
+ * 		(DEFAULT_RESERVE_SIZE for 0) and is a MAP_SHARED mapping. The file
+ * 		grows in DEFAULT_COMMIT_SIZE steps as the arena fills. Allocations
+ * 		that do not fit in the reservation fail. arena_free unmaps the file
+ * 		and records the used size in the header. Use arena_file_sync for a
+ * 		durable image.
+ *
+ * 		With O_RDONLY the mapping is MAP_PRIVATE. The image can be read
+ * 		and written, but nothing goes back to the file, and it can't grow.
+ *
+ * 		Store pointers inside the image as glad_rel or as offsets from the
+ * 		root, since the file may be mapped at a different address next time.
+ *
+ * @param arena 	An arena without chunks, e.g. fresh from arena_init.
+ * @param path 		The file to open.
+ * @param oflag 	Flags for open(2): O_RDONLY or O_RDWR, optionally O_CREAT.
+ *
+ * @return 	1 on success. 0 with errno set if the file can't be opened or
+ * 		mapped, or EINVAL if it is not an image of this build.
+ */
+GLAD_DEF int arena_file_open(arena* arena, const char* path, int oflag)
+{
+	if (!arena || !path || arena->ar_head) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	int fd = open(path, oflag, 0644);
+	if (fd == -1)
+		return 0;
+	if (arena_file_map(arena, fd, (oflag & O_ACCMODE) != O_RDONLY))
+		return 1;
+
+	int error = errno;
+	close(fd);
+	errno = error;
+	return 0;
+}
+
+/** 
+ * @brief	Writes a file-backed arena's image back to its file.
+ *
+ * @details
+ * 		Records the used size in the header and waits for msync(MS_SYNC),
+ * 		so a crash afterwards still leaves a consistent image.
+ *
+ * @param arena The arena, opened with arena_file_open and O_RDWR.
+ *
+ * @return 	1 on success, 0 if the arena is not file-backed or msync fails.
+ */
+GLAD_DEF int arena_file_sync(arena* arena)
+{
+	if (!arena || !arena->ar_head || !(arena->ar_head->ch_flags & CHUNK_FILE))
+		return 0;
+
+	arena_sync(arena);
+	chunk* ch = arena->ar_head;
+	ptrdiff_t page = sysconf(_SC_PAGESIZE);
+	chunk_image(ch)->im_used = ch->ch_offset;
+	ptrdiff_t length = GLAD_IMAGE_OFFSET + ROUND_UP((ptrdiff_t)CHUNK_ALLOC_SIZE(ch->ch_offset), page);
+	return !msync(chunk_image(ch), length, MS_SYNC);
+}
+
+/** 
+ * @brief	Records root as the root object of a file-backed arena's image.
+ *
+ * @param arena The file-backed arena.
+ * @param root 	A pointer into the arena, or 0 to clear the root.
+ */
+GLAD_DEF void arena_set_root(arena* arena, const void* root)
+{
+	if (!arena || !arena->ar_head || !(arena->ar_head->ch_flags & CHUNK_FILE))
+		return;
+	chunk* ch = arena->ar_head;
+	chunk_image(ch)->im_root = root ? (int64_t)((uintptr_t)root - (uintptr_t)ch->ch_data) : -1;
+}
+
+/** 
+ * @brief	Returns the root object of a file-backed arena's image.
+ *
+ * @param arena The file-backed arena.
+ *
+ * @return 	The root at this arena's address, or 0 if none was set.
+ */
+GLAD_DEF void* arena_get_root(arena* arena)
+{
+	if (!arena || !arena->ar_head || !(arena->ar_head->ch_flags & CHUNK_FILE))
+		return 0;
+	chunk* ch = arena->ar_head;
+	int64_t root = chunk_image(ch)->im_root;
+	return root < 0 ? 0 : ch->ch_data + root;
+}
+
+/** 
+ * @brief	Points a glad_rel at ptr.
+ *
+ * @param rel 	The relative pointer, stored where it will be read back from.
+ * @param ptr 	The target, or 0.
+ */
+GLAD_DEF void glad_rel_set(glad_rel* rel, const void* ptr)
+{
+	*rel = ptr ? (ptrdiff_t)((uintptr_t)ptr - (uintptr_t)rel) : 0;
+}
+
+/** 
+ * @brief	Returns the target of a glad_rel, or 0 for a null one.
+ */
+GLAD_DEF void* glad_rel_get(const glad_rel* rel)
+{
+	return *rel ? (void*)((uintptr_t)rel + *rel) : 0;
+}
+
+/** 
+ * @brief	Reads fd until end of file into one region of the arena.
+ *
+ * @details
+ * 		read(2) goes straight into the arena, with no buffer in between.
+ * 		Regular files are read into a region of their size. Pipes and 
+ * 		sockets start with DEFAULT_READ_SIZE bytes, which are doubled as 
+ * 		they fill: in place while the current chunk has room, or by moving
+ * 		what was read so far into a new chunk. The region is shrunk to 
+ * 		the data once the end is reached.
+ *
+ * @param arena The arena to read into.
+ * @param fd 	The file, pipe or socket, read from its current offset.
+ * @param size 	Set to the number of bytes read, or -1 on failure.
+ * @param flags Flags for arena_alloc, e.g. `SOFTFAIL`. `ZEROMEM` is ignored.
+ *
+ * @return 	The data, followed by a 0 byte that isn't counted in size. 0 with
+ * 		errno set if reading or allocating fails; nothing stays allocated then.
+ */
+GLAD_DEF void* arena_read_fd(arena* arena, int fd, ptrdiff_t* size, int flags)
+{
+	if (size)
+		*size = -1;
+	if (!arena || fd < 0 || !size) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	/* one byte more leaves room for the 0, and to see the end of file */
+	ptrdiff_t cap = DEFAULT_READ_SIZE;
+	struct stat st;
+	if (!fstat(fd, &st) && S_ISREG(st.st_mode) && st.st_size < PTRDIFF_MAX)
+		cap = (ptrdiff_t)st.st_size + 1;
+
+	flags &= ~ZEROMEM;
+	arena_savepoint mark = arena_mark(arena);
+	char* data = (char*)arena_alloc(arena, cap, 1, flags);
+	ptrdiff_t used = 0;
+	while (data) {
+		if (used == cap) {
+			ptrdiff_t grown = cap <= PTRDIFF_MAX / 2 ? cap * 2 : 0;
+			data = grown ? (char*)arena_realloc(arena, data, cap, grown, 1, flags) : 0;
+			cap = grown;
+			if (!data)
+				break;
+		}
+		ssize_t got = read(fd, data + used, cap - used);
+		if (got > 0) {
+			used += got;
+		} else if (!got) {
+			data[used] = 0;
+			arena_extend(arena, data, cap, used + 1, 1, 0);
+			*size = used;
+			return data;
+		} else if (errno != EINTR) {
+			int error = errno;
+			arena_rewind(arena, mark);
+			errno = error;
+			return 0;
+		}
+	}
+
+	arena_rewind(arena, mark);
+	errno = ENOMEM;
+	return 0;
+}
+
+/** 
+ * @brief	Reads whatever fd has ready, up to max bytes, into the arena.
+ *
+ * @details
+ * 		Makes a single read(2) call into the tail of the current chunk.
+ * 		Reads are capped at the room left in it, so a stream fills the
+ * 		chunk before it rolls into a new one, and the data of consecutive
+ * 		calls is contiguous as long as nothing else is allocated in 
+ * 		between and the chunk stays the same.
+ *
+ * @param arena The arena to read into.
+ * @param fd 	The file, pipe or socket. Non-blocking ones work too.
+ * @param max 	The most bytes to read.
+ * @param size 	Set to the number of bytes read, 0 at end of file, or -1 on failure.
+ * @param flags Flags for arena_alloc, e.g. `SOFTFAIL`. `ZEROMEM` is ignored.
+ *
+ * @return 	The data, or 0 at end of file and on failure, with errno set
+ * 		then, e.g. to EAGAIN. Nothing stays allocated when 0 is returned.
+ */
+GLAD_DEF void* arena_push_stream(arena* arena, int fd, ptrdiff_t max, ptrdiff_t* size, int flags)
+{
+	if (size)
+		*size = -1;
+	if (!arena || fd < 0 || max <= 0 || !size) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	ptrdiff_t room = arena->ar_end - arena->ar_ptr;
+	ptrdiff_t want = room > 0 && room < max ? room : max;
+	arena_savepoint mark = arena_mark(arena);
+	char* data = (char*)arena_alloc(arena, want, 1, flags & ~ZEROMEM);
+	if (!data) {
+		errno = ENOMEM;
+		return 0;
+	}
+
+	ssize_t got;
+	do {
+		got = read(fd, data, want);
+	} while (got == -1 && errno == EINTR);
+	if (got <= 0) {
+		int error = errno;
+		arena_rewind(arena, mark);
+		errno = error;
+		*size = got ? -1 : 0;
+		return 0;
+	}
+
+	if (got < want)
+		arena_extend(arena, data, want, got, 1, 0);
+	*size = got;
+	return data;
+}
+
+/** 
+ * @brief	Maps a whole file into the arena instead of reading it.
+ *
+ * @details
+ * 		The file gets a chunk of its own, a MAP_PRIVATE mapping that lives
+ * 		until the arena is freed, or rewound past it. Pages are read in 
+ * 		as they are touched, and writes to them are copy-on-write, so the
+ * 		data can be edited in place without changing the file. The chunk
+ * 		header sits on a page of its own in front of the data, so nothing
+ * 		is ever copied. 
+ *
+ * 		Pipes, sockets and empty files can't be mapped, and are read with
+ * 		arena_read_fd instead.
+ *
+ * @param arena The arena to map into. File-backed arenas are refused.
+ * @param fd 	The file. Its offset is ignored and left alone.
+ * @param size 	Set to the size of the file, or -1 on failure.
+ * @param flags Flags for arena_read_fd.
+ *
+ * @return 	The data, followed by a 0 byte that isn't counted in size. 0 with
+ * 		errno set on failure.
+ */
+GLAD_DEF void* arena_map_fd(arena* arena, int fd, ptrdiff_t* size, int flags)
+{
+	if (size)
+		*size = -1;
+	if (!arena || fd < 0 || !size || (arena->ar_head && arena->ar_head->ch_flags & CHUNK_FILE)) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st))
+		return 0;
+	if (!S_ISREG(st.st_mode) || st.st_size <= 0)
+		return arena_read_fd(arena, fd, size, flags);
+
+	/* the page after the end of file, if the file fills its last page, provides the 0 */
+	ptrdiff_t page = sysconf(_SC_PAGESIZE);
+	ptrdiff_t length = ROUND_UP((ptrdiff_t)st.st_size + 1, page);
+	char* base = (char*)glad_mmap(page + length, PROT_READ | PROT_WRITE, 0);
+	if (base == (char*)MAP_FAILED)
+		return 0;
+	if (mmap(base + page, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+		int error = errno;
+		munmap(base, page + length);
+		errno = error;
+		return 0;
+	}
+#ifdef MADV_WILLNEED
+	/* start readahead now, the caller is about to go through all of it */
+	madvise(base + page, st.st_size, MADV_WILLNEED);
+#endif
+
+	chunk* ch = (chunk*)(base + page - sizeof(chunk));
+	ch->ch_next = 0;
+	/* sized to the text and its 0, so nothing else lands in the file's pages */
+	ch->ch_size = st.st_size + 1;
+	ch->ch_commit = ch->ch_size;
+	ch->ch_offset = ch->ch_size;
+	ch->ch_dirty = ch->ch_offset;
+	ch->ch_flags = CHUNK_MAPPED;
+	ch->ch_fd = -1;
+
+	/* the chunk is full, so the bump pointer stays where it is. After a reset
+	 * or rewind its copy-on-write pages are reused like any other chunk's, 
+	 * which never writes to the file. */
+	if (arena->ar_tail)
+		arena->ar_tail->ch_next = ch;
+	else
+		arena->ar_head = ch;
+	arena->ar_tail = ch;
+	GLAD_STAT(arena_stats_add(arena, 1, st.st_size, ch->ch_offset));
+	arena_track_chunk(arena, ch);
+	arena->ar_used += ch->ch_offset;
+	*size = st.st_size;
+	return ch->ch_data;
+}
+
+/** 
+ * @brief	Initializes an empty pool on top of the arena.
+ *
+ * @param pool 	The pool to initialize.
+ * @param arena The arena nodes are carved out of.
+ */
+GLAD_DEF void pool_init(arena_pool* pool, arena* arena)
+{
+	if (!pool)
+		return;
+	memset(pool, 0, sizeof *pool);
+	pool->ap_arena = arena;
+}
+
+/** 
+ * @brief	Finds the size class of a node.
+ *
+ * @details
+ * 		Nodes are as large as their class and aligned to it, so any node
+ * 		of a class can serve any request that maps to that class.
+ *
+ * @param size 		The size of the node.
+ * @param alignment 	The alignment of the node.
+ *
+ * @return 	The index into ap_free, or -1 if the node is too large for the pool.
+ */
+GLAD_DEF int pool_class(ptrdiff_t size, ptrdiff_t alignment)
+{
+	if (size < alignment)
+		size = alignment;
+	int size_class = 0;
+	while (size_class < POOL_CLASSES && ((ptrdiff_t)1 << (POOL_MIN_SHIFT + size_class)) < size)
+		++size_class;
+	return size_class < POOL_CLASSES ? size_class : -1;
+}
+
+/** 
+ * @brief	Allocates a node from the pool.
+ *
+ * @details
+ * 		Pops the free list of the node's size class, and only carves a new
+ * 		node out of the arena when it is empty. Nodes larger than the
+ * 		largest class come straight from the arena and are not reused.
+ *
+ * @param pool 		The pool to allocate from.
+ * @param size 		The size of the node.
+ * @param alignment 	The alignment of the node, a power of two.
+ * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory.
+ *
+ * @return 	A pointer to the node, or 0 if the allocation fails.
+ */
+GLAD_DEF void* pool_alloc(arena_pool* pool, ptrdiff_t size, ptrdiff_t alignment, int flags)
+{
+	if (!pool || size <= 0 || alignment <= 0 || alignment & (alignment - 1))
+		return 0;
+
+	int size_class = pool_class(size, alignment);
+	if (size_class < 0)
+		return arena_alloc(pool->ap_arena, size, alignment, flags);
+
+	ptrdiff_t class_size = (ptrdiff_t)1 << (POOL_MIN_SHIFT + size_class);
+	void* node = pool->ap_free[size_class];
+	if (!node)
+		return arena_alloc(pool->ap_arena, class_size, class_size, flags);
+
+	GLAD_UNPOISON(node, class_size);
+	pool->ap_free[size_class] = *(void**)node;
+	if (flags & ZEROMEM)
+		memset(node, 0, class_size);
+	return node;
+}
+
+/** 
+ * @brief	Gives a node back to the pool, in O(1).
+ *
+ * @details
+ * 		size and alignment must match the pool_alloc call that returned
+ * 		the node. Nodes too large for the pool stay in the arena unused.
+ *
+ * @param pool 		The pool the node was allocated from.
+ * @param node 		The node to free, or 0.
+ * @param size 		The size the node was allocated with.
+ * @param alignment 	The alignment the node was allocated with.
+ */
+GLAD_DEF void pool_free(arena_pool* pool, void* node, ptrdiff_t size, ptrdiff_t alignment)
+{
+	if (!pool || !node)
+		return;
+
+	int size_class = pool_class(size, alignment);
+	if (size_class < 0)
+		return;
+
+	*(void**)node = pool->ap_free[size_class];
+	pool->ap_free[size_class] = node;
+	/* the link stays readable, the rest of the node traps stale accesses */
+	GLAD_POISON((char*)node + sizeof(void*), ((ptrdiff_t)1 << (POOL_MIN_SHIFT + size_class)) - sizeof(void*));
+}
+
+/** 
+ * @brief	Empties the pool's free lists.
+ *
+ * @details
+ * 		Must be called when the arena is reset, cleared, rewound or freed,
+ * 		since the lists point into memory the arena reuses.
+ *
+ * @param pool The pool to reset.
+ */
+GLAD_DEF void pool_reset(arena_pool* pool)
+{
+	if (pool)
+		memset(pool->ap_free, 0, sizeof pool->ap_free);
+}
+
+/** 
+ * @brief	Initializes an empty array of elements of the given size.
+ *
+ * @param vec 		The array to initialize.
+ * @param arena 	The arena the elements live in.
+ * @param elem 		The size of an element.
+ * @param alignment 	The alignment of an element, a power of two.
+ */
+GLAD_DEF void vec_init(arena_vec* vec, arena* arena, ptrdiff_t elem, ptrdiff_t alignment)
+{
+	if (!vec)
+		return;
+	memset(vec, 0, sizeof *vec);
+	vec->av_arena = arena;
+	vec->av_elem = elem;
+	vec->av_align = alignment;
+}
+
+/** 
+ * @brief	Makes room for at least cap elements.
+ *
+ * @details
+ * 		The capacity at least doubles, so that appending stays amortized
+ * 		O(1) even when the array is not the arena's tail and has to move.
+ *
+ * @param vec 	The array to grow.
+ * @param cap 	The number of elements needed.
+ *
+ * @return 	1 on success, 0 if the allocation fails.
+ */
+GLAD_DEF int vec_reserve(arena_vec* vec, ptrdiff_t cap)
+{
+	if (cap <= vec->av_cap)
+		return 1;
+	if (vec->av_elem <= 0 || cap > PTRDIFF_MAX / vec->av_elem)
+		return 0;
+
+	ptrdiff_t new_cap = vec->av_cap < 8 ? 8 : vec->av_cap;
+	while (new_cap < cap)
+		new_cap = new_cap > PTRDIFF_MAX / 2 / vec->av_elem ? cap : new_cap * 2;
+
+	char* data = (char*)arena_realloc(vec->av_arena, vec->av_data, vec->av_cap * vec->av_elem, 
+			new_cap * vec->av_elem, vec->av_align, 0);
+	if (!data)
+		return 0;
+	vec->av_data = data;
+	vec->av_cap = new_cap;
+	return 1;
+}
+
+/** 
+ * @brief	Appends count elements to the array.
+ *
+ * @param vec 	The array to append to.
+ * @param count The number of elements to append.
+ * @param flags Flags that modify allocation behavior, e.g., `ZEROMEM` to zero the new elements.
+ *
+ * @return 	A pointer to the first new element, or 0 if the allocation fails.
+ */
+GLAD_DEF void* vec_extend(arena_vec* vec, ptrdiff_t count, int flags)
+{
+	if (!vec || count < 0 || vec->av_len > PTRDIFF_MAX - count)
+		return 0;
+	if (!vec_reserve(vec, vec->av_len + count))
+		return 0;
+
+	char* start = vec->av_data + vec->av_len * vec->av_elem;
+	if (flags & ZEROMEM)
+		memset(start, 0, count * vec->av_elem);
+	vec->av_len += count;
+	return start;
+}
+
+/** 
+ * @brief	Appends a copy of the element at data.
+ *
+ * @return 	A pointer to the new element, or 0 if the allocation fails.
+ */
+GLAD_DEF void* vec_push(arena_vec* vec, const void* data)
+{
+	void* slot = vec_extend(vec, 1, 0);
+	if (slot)
+		memcpy(slot, data, vec->av_elem);
+	return slot;
+}
+
+/** 
+ * @brief	Initializes an empty string builder.
+ */
+GLAD_DEF void str_init(arena_str* str, arena* arena)
+{
+	vec_init(str, arena, 1, 1);
+}
+
+/** 
+ * @brief	Appends size bytes of data to the string.
+ *
+ * @return 	A pointer to the appended bytes, or 0 if the allocation fails.
+ */
+GLAD_DEF char* str_push(arena_str* str, const char* data, ptrdiff_t size)
+{
+	char* start = (char*)vec_extend(str, size, 0);
+	if (start)
+		memcpy(start, data, size);
+	return start;
+}
+
+/** 
+ * @brief	Appends a NUL-terminated string, without its terminator.
+ */
+GLAD_DEF char* str_cat(arena_str* str, const char* cstr)
+{
+	return str_push(str, cstr, strlen(cstr));
+}
+
+/** 
+ * @brief	Appends printf-style formatted text.
+ *
+ * @details
+ * 		Formats straight into the string's spare capacity, growing it and 
+ * 		formatting again only when the text does not fit.
+ *
+ * @return 	A pointer to the appended text, or 0 on failure.
+ */
+GLAD_DEF char* str_printf(arena_str* str, const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	ptrdiff_t spare = str->av_cap - str->av_len;
+	int size = vsnprintf(spare ? str->av_data + str->av_len : 0, spare, fmt, args);
+	va_end(args);
+	if (size < 0)
+		return 0;
+
+	if (size >= spare) {
+		/* room for the terminator vsnprintf writes */
+		if (!vec_reserve(str, str->av_len + size + 1))
+			return 0;
+		va_start(args, fmt);
+		vsnprintf(str->av_data + str->av_len, size + 1, fmt, args);
+		va_end(args);
+	}
+	char* start = str->av_data + str->av_len;
+	str->av_len += size;
+	return start;
+}
+
+/** 
+ * @brief	NUL-terminates the string without counting the terminator in av_len.
+ *
+ * @return 	The string, or 0 if the allocation fails.
+ */
+GLAD_DEF char* str_cstr(arena_str* str)
+{
+	if (!vec_reserve(str, str->av_len + 1))
+		return 0;
+	str->av_data[str->av_len] = 0;
+	return str->av_data;
+}
+
+/** 
+ * @brief	Initializes an empty map with values of the given size.
+ *
+ * @param map 		The map to initialize.
+ * @param arena 	The arena the keys and values live in.
+ * @param elem 		The size of a value.
+ * @param alignment 	The alignment of a value, a power of two.
+ */
+GLAD_DEF void map_init(arena_map* map, arena* arena, ptrdiff_t elem, ptrdiff_t alignment)
+{
+	if (!map)
+		return;
+	memset(map, 0, sizeof *map);
+	map->am_arena = arena;
+	map->am_elem = elem;
+	map->am_align = alignment;
+}
+
+/** 
+ * @brief	Mixes the bits of a key, the finalizer of MurmurHash3.
+ */
+GLAD_DEF uint64_t map_hash(uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+	return key;
+}
+
+/** 
+ * @brief	Finds the slot of key, or the empty slot where it would go.
+ */
+GLAD_DEF ptrdiff_t map_slot(const arena_map* map, uint64_t key)
+{
+	ptrdiff_t mask = map->am_cap - 1;
+	ptrdiff_t i = (ptrdiff_t)(map_hash(key) & mask);
+	while (map->am_keys[i] && map->am_keys[i] != key)
+		i = (i + 1) & mask;
+	return i;
+}
+
+/** 
+ * @brief	Moves the map into arrays of cap slots.
+ *
+ * @return 	1 on success, 0 if the allocation fails.
+ */
+GLAD_DEF int map_grow(arena_map* map, ptrdiff_t cap)
+{
+	if (cap > PTRDIFF_MAX / map->am_elem - 1 || cap > PTRDIFF_MAX / (ptrdiff_t)sizeof(uint64_t))
+		return 0;
+	uint64_t* keys = (uint64_t*)arena_alloc(map->am_arena, cap * sizeof(uint64_t), alignof(uint64_t), ZEROMEM);
+	char* vals = (char*)arena_alloc(map->am_arena, (cap + 1) * map->am_elem, map->am_align, 0);
+	if (!keys || !vals)
+		return 0;
+
+	arena_map grown = *map;
+	grown.am_keys = keys;
+	grown.am_vals = vals;
+	grown.am_cap = cap;
+	for (ptrdiff_t i = 0; i < map->am_cap; ++i) {
+		if (!map->am_keys[i])
+			continue;
+		ptrdiff_t slot = map_slot(&grown, map->am_keys[i]);
+		keys[slot] = map->am_keys[i];
+		memcpy(vals + slot * map->am_elem, map->am_vals + i * map->am_elem, map->am_elem);
+	}
+	if (map->am_has_zero)
+		memcpy(vals + cap * map->am_elem, map->am_vals + map->am_cap * map->am_elem, map->am_elem);
+	*map = grown;
+	return 1;
+}
+
+/** 
+ * @brief	Looks up the value of key.
+ *
+ * @return 	A pointer to the value, or 0 if the key is not in the map.
+ */
+GLAD_DEF void* map_get(const arena_map* map, uint64_t key)
+{
+	if (!map || !map->am_cap)
+		return 0;
+	if (!key)
+		return map->am_has_zero ? map->am_vals + map->am_cap * map->am_elem : 0;
+
+	ptrdiff_t slot = map_slot(map, key);
+	return map->am_keys[slot] ? map->am_vals + slot * map->am_elem : 0;
+}
+
+/** 
+ * @brief	Finds or inserts key.
+ *
+ * @details
+ * 		New values are zeroed. The map grows once it is three quarters
+ * 		full, which invalidates pointers to its values.
+ *
+ * @return 	A pointer to the value, or 0 if the allocation fails.
+ */
+GLAD_DEF void* map_put(arena_map* map, uint64_t key)
+{
+	if (!map)
+		return 0;
+	if (4 * (map->am_len + 1) > 3 * map->am_cap && !map_grow(map, map->am_cap ? 2 * map->am_cap : 16))
+		return 0;
+
+	char* value;
+	if (!key) {
+		value = map->am_vals + map->am_cap * map->am_elem;
+		if (map->am_has_zero)
+			return value;
+		map->am_has_zero = 1;
+	} else {
+		ptrdiff_t slot = map_slot(map, key);
+		value = map->am_vals + slot * map->am_elem;
+		if (map->am_keys[slot])
+			return value;
+		map->am_keys[slot] = key;
+	}
+	memset(value, 0, map->am_elem);
+	map->am_len += 1;
+	return value;
+}
+
+/** 
+ * @brief	Removes key from the map.
+ *
+ * @details
+ * 		Uses backward-shift deletion, so no tombstones are left behind and
+ * 		lookups never slow down as keys come and go.
+ *
+ * @return 	1 if the key was removed, 0 if it was not in the map.
+ */
+GLAD_DEF int map_del(arena_map* map, uint64_t key)
+{
+	if (!map || !map->am_cap)
+		return 0;
+	if (!key) {
+		if (!map->am_has_zero)
+			return 0;
+		map->am_has_zero = 0;
+		map->am_len -= 1;
+		return 1;
+	}
+
+	ptrdiff_t mask = map->am_cap - 1;
+	ptrdiff_t hole = map_slot(map, key);
+	if (!map->am_keys[hole])
+		return 0;
+
+	/* pull later keys of the probe sequence back into the hole */
+	for (ptrdiff_t i = (hole + 1) & mask; map->am_keys[i]; i = (i + 1) & mask) {
+		ptrdiff_t home = (ptrdiff_t)(map_hash(map->am_keys[i]) & mask);
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			map->am_keys[hole] = map->am_keys[i];
+			memcpy(map->am_vals + hole * map->am_elem, map->am_vals + i * map->am_elem, map->am_elem);
+			hole = i;
+		}
+	}
+	map->am_keys[hole] = 0;
+	map->am_len -= 1;
+	return 1;
+}
 
-		copy_dst->ar_tail = new_chunk;
-		dst_cursor = new_chunk;
-		src_cursor = src_cursor->ch_next;
+/** 
+ * @brief	Steps through the map's keys in slot order.
+ *
+ * @details
+ * 		Start with *iter set to 0. The map must not be changed while 
+ * 		iterating, except through the value pointers.
+ *
+ * @param map 	The map to iterate over.
+ * @param iter 	The iteration state.
+ * @param key 	Set to the next key.
+ * @param value Set to a pointer to its value.
+ *
+ * @return 	1 if a key was found, 0 at the end.
+ */
+GLAD_DEF int map_next(const arena_map* map, ptrdiff_t* iter, uint64_t* key, void** value)
+{
+	for (; *iter < map->am_cap; ++*iter) {
+		if (map->am_keys[*iter]) {
+			*key = map->am_keys[*iter];
+			*value = map->am_vals + *iter * map->am_elem;
+			++*iter;
+			return 1;
+		}
+	}
+	if (*iter == map->am_cap && map->am_has_zero) {
+		*key = 0;
+		*value = map->am_vals + map->am_cap * map->am_elem;
+		++*iter;
+		return 1;
+	}
+	return 0;
+}
+
+#ifdef GLAD_THREADS
+/** 
+ * @brief	Initializes an empty concurrent arena with the given options.
+ *
+ * @param ca 		The arena to initialize. Must not own any chunks.
+ * @param config 	The options to apply, or 0 for the defaults. A chunk_cache
+ * 			in the config is only touched under ca_lock.
+ *
+ * @return 	0 on success, an errno value if the lock can't be created.
+ */
+GLAD_DEF int carena_init(carena* ca, const arena_config* config)
+{
+	if (!ca)
+		return EINVAL;
+
+	arena_init(&ca->ca_arena, config);
+	ca->ca_curr = 0;
+	ca->ca_epoch = 0;
+	return pthread_mutex_init(&ca->ca_lock, 0);
+}
+
+/** 
+ * @brief	Makes a chunk with room for claim bytes the current one.
+ *
+ * @details
+ * 		Called with ca_lock held after a fetch-add ran past the end of seen.
+ * 		If another thread has already replaced seen, there is nothing to do.
+ * 		Otherwise the next spare chunk with room is used, or a new one is 
+ * 		appended to the list.
+ *
+ * @param ca 	The concurrent arena.
+ * @param seen 	The current chunk at the time of the failed claim.
+ * @param claim Number of bytes the caller needs to claim.
+ * @param flags Flags that modify allocation behavior, see alloc_chunk.
+ *
+ * @return 	1 if the caller should retry, 0 if a new chunk could not be mapped.
+ */
+GLAD_NOINLINE int carena_grow(carena* ca, chunk* seen, ptrdiff_t claim, int flags)
+{
+	if (__atomic_load_n(&ca->ca_curr, __ATOMIC_RELAXED) != seen)
+		return 1;
+
+	arena* ar = &ca->ca_arena;
+	/* a RESERVE chunk may just need more of it committed */
+	if (seen) {
+		ptrdiff_t offset = __atomic_load_n(&seen->ch_offset, __ATOMIC_RELAXED);
+		if (offset <= seen->ch_size - claim && chunk_commit(seen, offset + claim))
+			return 1;
+	}
+
+	chunk* next = seen ? seen->ch_next : ar->ar_head;
+	while (next && (next->ch_size - next->ch_offset < claim || !chunk_commit(next, next->ch_offset + claim)))
+		next = next->ch_next;
+
+	if (!next) {
+		ptrdiff_t chunk_size = arena_next_chunk_size(ar, claim + CARENA_GRAIN);
+		next = chunk_size ? arena_new_chunk(ar, chunk_size, flags | ar->ar_flags) : 0;
+		if (!next)
+			return 0;
+
+		/* start on a grain boundary, so claims stay aligned to it */
+		next->ch_offset = ROUND_UP((uintptr_t)next->ch_data, CARENA_GRAIN) - (uintptr_t)next->ch_data;
+		if (!chunk_commit(next, next->ch_offset + claim)) {
+			cache_free_chunk(ar->ar_cache, next);
+			return 0;
+		}
+		if (ar->ar_tail)
+			ar->ar_tail->ch_next = next;
+		else
+			ar->ar_head = next;
+		ar->ar_tail = next;
+		/* claims go straight to ch_offset, so ar_used is not kept, see carena_get_size */
+		arena_track_chunk(ar, next);
+	}
+
+	__atomic_store_n(&ca->ca_curr, next, __ATOMIC_RELEASE);
+	return 1;
+}
+
+/** 
+ * @brief 	Allocates num_bytes in the given concurrent arena.
+ * 
+ * @details
+ * 		Safe to call from any number of threads. The fast path is a single
+ * 		atomic fetch-add on the current chunk. Alignments above 
+ * 		`CARENA_GRAIN` claim their worst-case padding up front, so the 
+ * 		returned region is aligned like with arena_alloc. `FIRSTFIT` is 
+ * 		ignored.
+ *
+ * @param ca 		The arena in which memory will be allocated.
+ * @param num_bytes 	Number of bytes to allocate.
+ * @param alignment 	Alignment of the returned region, must be a power of 2.
+ * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory.
+ *
+ * @return 	A pointer to the start of the allocated memory region. Null if the 
+ * 		allocation fails. 
+ */
+GLAD_DEF void* carena_alloc(carena* ca, const ptrdiff_t num_bytes, const ptrdiff_t alignment, int flags)
+{
+	if (!ca || num_bytes <= 0 || alignment <= 0 || alignment & (alignment - 1))
+		return 0;
+
+	ptrdiff_t alloc_size = ROUND_UP(num_bytes, alignment);
+	ptrdiff_t claim = ROUND_UP(alloc_size, CARENA_GRAIN);
+	if (alignment > CARENA_GRAIN)
+		claim += alignment - CARENA_GRAIN;
+	if (alloc_size < num_bytes || claim < alloc_size)
+		return 0;
+
+	for (;;) {
+		chunk* curr = __atomic_load_n(&ca->ca_curr, __ATOMIC_ACQUIRE);
+		if (curr) {
+			ptrdiff_t offset = __atomic_fetch_add(&curr->ch_offset, claim, __ATOMIC_RELAXED);
+			if (offset <= __atomic_load_n(&curr->ch_commit, __ATOMIC_ACQUIRE) - claim) {
+				char* start_addr = (char*)ROUND_UP((uintptr_t)&curr->ch_data[offset], (uintptr_t)alignment);
+				if (flags & ZEROMEM)
+					chunk_zero(curr, start_addr, alloc_size);
+				return start_addr;
+			}
+		}
+
+		/* the chunk is full; whoever gets the lock first replaces it */
+		pthread_mutex_lock(&ca->ca_lock);
+		int retry = carena_grow(ca, curr, claim, flags);
+		pthread_mutex_unlock(&ca->ca_lock);
+		if (!retry)
+			return 0;
+	}
+}
+
+/** 
+ * @brief	Clamps ch_offset values that failed claims pushed past ch_commit.
+ *
+ * @param ca 	The concurrent arena, which must be quiescent.
+ */
+GLAD_DEF void carena_settle(carena* ca)
+{
+	for (chunk* cursor = ca->ca_arena.ar_head; cursor; cursor = cursor->ch_next) {
+		if (cursor->ch_offset > cursor->ch_commit)
+			cursor->ch_offset = cursor->ch_commit;
+	}
+}
+
+/** 
+ * @brief	Gets the total claimed size of the concurrent arena.
+ *
+ * @details
+ * 		Safe to call while other threads allocate, in which case the result
+ * 		is a snapshot. Includes the padding claimed for large alignments.
+ *
+ * @param ca 	The arena for which to calculate the in-use size.
+ *
+ * @return 	The computed size.
+ */
+GLAD_DEF ptrdiff_t carena_get_size(carena* ca)
+{
+	if (!ca)
+		return 0;
+
+	pthread_mutex_lock(&ca->ca_lock);
+	ptrdiff_t size = 0;
+	for (chunk* cursor = ca->ca_arena.ar_head; cursor; cursor = cursor->ch_next) {
+		ptrdiff_t offset = __atomic_load_n(&cursor->ch_offset, __ATOMIC_RELAXED);
+		ptrdiff_t commit = __atomic_load_n(&cursor->ch_commit, __ATOMIC_RELAXED);
+		size += offset < commit ? offset : commit;
+	}
+	pthread_mutex_unlock(&ca->ca_lock);
+	return size;
+}
+
+/** 
+ * @brief 	Marks the whole concurrent arena as unallocated.
+ *
+ * @details
+ * 		Does not set the associated memory. The arena must be quiescent.
+ *
+ * @param ca 	The arena to reset.
+ */
+GLAD_DEF void carena_reset(carena* ca)
+{
+	if (!ca)
+		return;
+
+	carena_settle(ca);
+	for (chunk* cursor = ca->ca_arena.ar_head; cursor; cursor = cursor->ch_next) {
+		if (cursor->ch_offset > cursor->ch_dirty)
+			cursor->ch_dirty = cursor->ch_offset;
+		cursor->ch_offset = ROUND_UP((uintptr_t)cursor->ch_data, CARENA_GRAIN) - (uintptr_t)cursor->ch_data;
+	}
+	ca->ca_curr = ca->ca_arena.ar_head;
+	__atomic_add_fetch(&ca->ca_epoch, 1, __ATOMIC_RELAXED);
+}
+
+/** 
+ * @brief  Frees the given concurrent arena and its lock.
+ *
+ * @param ca 	The arena to free, which must be quiescent.
+ * @param flags Flags that modify free behavior, e.g., `ZEROMEM` for zeroing memory.
+ */
+GLAD_DEF void carena_free(carena* ca, int flags)
+{
+	if (!ca)
+		return;
+
+	carena_settle(ca);
+	arena_free(&ca->ca_arena, flags);
+	ca->ca_curr = 0;
+	pthread_mutex_destroy(&ca->ca_lock);
+}
+
+/** 
+ * @brief	Initializes one concurrent arena per NUMA node.
+ *
+ * @details
+ * 		Each arena is initialized from config and binds its chunks to
+ * 		its node. Without GLAD_NUMA there is a single arena.
+ *
+ * @param set 		The set to initialize.
+ * @param config 	Options for every arena, or 0. ac_node is ignored.
+ *
+ * @return 	0 on success, or an error number.
+ */
+GLAD_DEF int carena_nodes_init(carena_nodes* set, const arena_config* config)
+{
+	if (!set)
+		return EINVAL;
+
+	arena_config node_config;
+	memset(&node_config, 0, sizeof node_config);
+	if (config)
+		node_config = *config;
+
+	int count = glad_node_count();
+	set->cn_arenas = (carena*)calloc(count, sizeof *set->cn_arenas);
+	set->cn_count = 0;
+	if (!set->cn_arenas)
+		return ENOMEM;
+	for (; set->cn_count < count; ++set->cn_count) {
+		node_config.ac_node = set->cn_count + 1;
+		int error = carena_init(&set->cn_arenas[set->cn_count], &node_config);
+		if (error) {
+			while (set->cn_count > 0)
+				carena_free(&set->cn_arenas[--set->cn_count], 0);
+			free(set->cn_arenas);
+			set->cn_arenas = 0;
+			return error;
+		}
+	}
+	return 0;
+}
+
+/** 
+ * @brief	Returns the arena of the node the calling thread runs on.
+ *
+ * @details
+ * 		Threads can move between nodes, so pinned threads should look 
+ * 		their arena up once, e.g. as the parent of their tarena.
+ *
+ * @param set 	The set, initialized with carena_nodes_init.
+ *
+ * @return 	The arena of the current node.
+ */
+GLAD_DEF carena* carena_nodes_local(carena_nodes* set)
+{
+	int node = glad_current_node();
+	return &set->cn_arenas[node < set->cn_count ? node : 0];
+}
+
+/** 
+ * @brief	Frees every arena of the set.
+ *
+ * @param set 	The set to free, which must be quiescent.
+ * @param flags Flags that modify free behavior, e.g., `ZEROMEM` for zeroing memory.
+ */
+GLAD_DEF void carena_nodes_free(carena_nodes* set, int flags)
+{
+	if (!set)
+		return;
+
+	for (int i = 0; i < set->cn_count; ++i)
+		carena_free(&set->cn_arenas[i], flags);
+	free(set->cn_arenas);
+	set->cn_arenas = 0;
+	set->cn_count = 0;
+}
+
+/** 
+ * @brief	Slow path of tarena_alloc, taken when the slab is used up.
+ *
+ * @details
+ * 		Requests larger than a quarter of a slab go straight to the parent,
+ * 		anything else starts a new slab. With `ZEROMEM` the parent zeroes 
+ * 		the whole slab, which is free for memory that was never handed out.
+ *
+ * @param ta 		The thread arena.
+ * @param alloc_size 	Number of bytes, already rounded to alignment.
+ * @param alignment 	A power of two.
+ * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory.
+ *
+ * @return 	A pointer to the allocated region, or 0 on failure.
+ */
+GLAD_NOINLINE void* tarena_alloc_slow(tarena* ta, ptrdiff_t alloc_size, ptrdiff_t alignment, int flags)
+{
+	ptrdiff_t slab = ta->ta_slab > 0 ? ROUND_UP(ta->ta_slab, SLAB_ALIGN) : DEFAULT_SLAB_SIZE;
+	if (alloc_size > slab / 4 || alignment > SLAB_ALIGN)
+		return carena_alloc(ta->ta_parent, alloc_size, alignment, flags);
+
+	char* start = (char*)carena_alloc(ta->ta_parent, slab, SLAB_ALIGN, flags);
+	if (!start)
+		return 0;
+
+	ta->ta_epoch = __atomic_load_n(&ta->ta_parent->ca_epoch, __ATOMIC_RELAXED);
+	ta->ta_end = start + slab;
+	ta->ta_zero = flags & ZEROMEM ? start : ta->ta_end;
+	ta->ta_ptr = start + alloc_size;
+	return start;
+}
+
+/** 
+ * @brief 	Allocates num_bytes from the calling thread's slab.
+ * 
+ * @details
+ * 		Must only be called by the thread that owns ta. The common case is a
+ * 		pointer bump, like arena_alloc.
+ *
+ * @param ta 		The thread arena, with ta_parent set.
+ * @param num_bytes 	Number of bytes to allocate.
+ * @param alignment 	Alignment of the returned region, must be a power of 2.
+ * @param flags 	Flags that modify allocation behavior, e.g., `ZEROMEM` for zeroing memory.
+ *
+ * @return 	A pointer to the start of the allocated memory region. Null if the 
+ * 		allocation fails. 
+ */
+GLAD_DEF void* tarena_alloc(tarena* ta, const ptrdiff_t num_bytes, const ptrdiff_t alignment, int flags)
+{
+	if (!ta || !ta->ta_parent || num_bytes <= 0 || alignment <= 0 || alignment & (alignment - 1))
+		return 0;
+
+	ptrdiff_t alloc_size = ROUND_UP(num_bytes, alignment);
+	if (alloc_size < num_bytes)
+		return 0;
+
+	// Fast path: bump the pointer within the slab, unless the parent was reset
+	uintptr_t start_addr = ROUND_UP((uintptr_t)ta->ta_ptr, (uintptr_t)alignment);
+	if ((intptr_t)((uintptr_t)ta->ta_end - start_addr) >= alloc_size
+			&& ta->ta_epoch == __atomic_load_n(&ta->ta_parent->ca_epoch, __ATOMIC_RELAXED)) {
+		ta->ta_ptr = (char*)(start_addr + alloc_size);
+		if (flags & ZEROMEM && start_addr < (uintptr_t)ta->ta_zero) {
+			ptrdiff_t dirty = (char*)ta->ta_zero - (char*)start_addr;
+			memset((void*)start_addr, 0, dirty < alloc_size ? dirty : alloc_size);
+		}
+		return (void*)start_addr;
 	}
+
+	return tarena_alloc_slow(ta, alloc_size, alignment, flags);
+}
+
+/** 
+ * @brief 	Drops the thread arena's slab.
+ *
+ * @details
+ * 		The rest of the slab stays claimed in the parent until it is reset.
+ * 		Not needed after carena_reset, which thread arenas notice on their own.
+ *
+ * @param ta 	The thread arena.
+ */
+GLAD_DEF void tarena_reset(tarena* ta)
+{
+	if (!ta)
+		return;
+
+	ta->ta_ptr = 0;
+	ta->ta_end = 0;
+	ta->ta_zero = 0;
 }
+#endif /* GLAD_THREADS */
 #endif /* GLAD_H */
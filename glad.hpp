@@ -0,0 +1,244 @@
+#ifndef GLAD_HPP
+#define GLAD_HPP
+
+/* C++17 layer over glad.h: an owning arena, a std::pmr::memory_resource and
+ * a typed STL allocator. Everything inlines down to arena_alloc. */
+
+#include "glad.h"
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace glad {
+
+/**
+ * @brief	Allocates from a C arena, throwing instead of returning 0.
+ *
+ * @param ar 		The arena to allocate from.
+ * @param size 		The number of bytes, 0 is treated as 1.
+ * @param alignment 	The alignment, a power of two.
+ * @param flags 	Flags for arena_alloc. SOFTFAIL is always added.
+ *
+ * @return 	The allocation. Throws std::bad_alloc on failure.
+ */
+inline void* allocate(::arena* ar, std::size_t size, std::size_t alignment, int flags = 0)
+{
+	if (size > PTRDIFF_MAX)
+		throw std::bad_alloc();
+	void* ptr = arena_alloc(ar, size ? (ptrdiff_t)size : 1, (ptrdiff_t)alignment, flags | SOFTFAIL);
+	if (!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+/* A move-only owner of an arena. The chunks are released when it goes away,
+ * after the destructors of the objects created with make, last first. */
+class arena {
+public:
+	arena() noexcept
+	{
+		arena_init(&ar_, 0);
+	}
+
+	explicit arena(const arena_config& config) noexcept
+	{
+		arena_init(&ar_, &config);
+	}
+
+	arena(const arena&) = delete;
+	arena& operator=(const arena&) = delete;
+
+	/* a C arena only points into its chunks, so it can be moved bytewise */
+	arena(arena&& other) noexcept : ar_(other.ar_)
+	{
+		arena_init(&other.ar_, 0);
+	}
+
+	arena& operator=(arena&& other) noexcept
+	{
+		if (this != &other) {
+			release();
+			ar_ = other.ar_;
+			arena_init(&other.ar_, 0);
+		}
+		return *this;
+	}
+
+	~arena()
+	{
+		release();
+	}
+
+	/**
+	 * @brief	Returns the C arena, for the rest of the glad.h API.
+	 */
+	::arena* get() noexcept
+	{
+		return &ar_;
+	}
+
+	/**
+	 * @brief	Allocates size bytes, see glad::allocate.
+	 */
+	void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t), int flags = 0)
+	{
+		return glad::allocate(&ar_, size, alignment, flags);
+	}
+
+	/**
+	 * @brief	Allocates storage for n objects of type T, like glad_new.
+	 *
+	 * @details
+	 * 		Nothing is constructed. The memory is zeroed unless flags say
+	 * 		otherwise, so it is only ready to use for trivial types.
+	 */
+	template <class T>
+	T* alloc(std::size_t n = 1, int flags = ZEROMEM)
+	{
+		if (n > PTRDIFF_MAX / sizeof(T))
+			throw std::bad_array_new_length();
+		return static_cast<T*>(allocate(n * sizeof(T), alignof(T), flags));
+	}
+
+	/**
+	 * @brief	Constructs a T in the arena from args.
+	 *
+	 * @details
+	 * 		Types with a non-trivial destructor are registered with
+	 * 		arena_on_free, so they are destroyed by reset, clear, the
+	 * 		destructor and arena_rewind in the reverse order of their
+	 * 		creation. Trivially destructible types cost nothing extra.
+	 *
+	 * @return 	The new object. Throws std::bad_alloc, or whatever the
+	 * 		constructor throws; nothing is registered then.
+	 */
+	template <class T, class... Args>
+	T* make(Args&&... args)
+	{
+		if constexpr (std::is_trivially_destructible_v<T>) {
+			return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		} else {
+			T* object = ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			if (!arena_on_free(&ar_, [](void* ptr) { static_cast<T*>(ptr)->~T(); }, object)) {
+				object->~T();
+				throw std::bad_alloc();
+			}
+			return object;
+		}
+	}
+
+	/**
+	 * @brief	Destroys the objects from make and resets the arena.
+	 */
+	void reset() noexcept
+	{
+		arena_reset(&ar_);
+	}
+
+	/**
+	 * @brief	Destroys the objects from make and clears the arena.
+	 */
+	void clear() noexcept
+	{
+		arena_clear(&ar_);
+	}
+
+	/**
+	 * @brief	Returns the bytes in use, see arena_get_size.
+	 */
+	std::size_t size() noexcept
+	{
+		return (std::size_t)arena_get_size(&ar_);
+	}
+
+private:
+	void release() noexcept
+	{
+		arena_free(&ar_, 0);
+	}
+
+	::arena ar_;
+};
+
+/* A std::pmr::memory_resource that allocates from an arena. Deallocation is
+ * a no-op: the memory comes back when the arena is reset or freed. */
+class memory_resource : public std::pmr::memory_resource {
+public:
+	explicit memory_resource(::arena* ar) noexcept : ar_(ar) {}
+	explicit memory_resource(glad::arena& ar) noexcept : ar_(ar.get()) {}
+
+	::arena* get() const noexcept
+	{
+		return ar_;
+	}
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override
+	{
+		return glad::allocate(ar_, bytes, alignment);
+	}
+
+	void do_deallocate(void*, std::size_t, std::size_t) noexcept override {}
+
+	/* resources over the same arena can free each other's memory, trivially */
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		const memory_resource* resource = dynamic_cast<const memory_resource*>(&other);
+		return resource && resource->ar_ == ar_;
+	}
+
+	::arena* ar_;
+};
+
+/* A typed STL allocator over an arena, for containers that take an allocator
+ * parameter. deallocate is a no-op, see memory_resource. */
+template <class T>
+class allocator {
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	explicit allocator(::arena* ar) noexcept : ar_(ar) {}
+	allocator(glad::arena& ar) noexcept : ar_(ar.get()) {}
+
+	template <class U>
+	allocator(const allocator<U>& other) noexcept : ar_(other.get()) {}
+
+	T* allocate(std::size_t n)
+	{
+		if (n > PTRDIFF_MAX / sizeof(T))
+			throw std::bad_array_new_length();
+		return static_cast<T*>(glad::allocate(ar_, n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T*, std::size_t) noexcept {}
+
+	::arena* get() const noexcept
+	{
+		return ar_;
+	}
+
+private:
+	::arena* ar_;
+};
+
+template <class T, class U>
+bool operator==(const allocator<T>& a, const allocator<U>& b) noexcept
+{
+	return a.get() == b.get();
+}
+
+template <class T, class U>
+bool operator!=(const allocator<T>& a, const allocator<U>& b) noexcept
+{
+	return a.get() != b.get();
+}
+
+} // namespace glad
+
+#endif
@@ -0,0 +1,363 @@
+/*
+ * Benchmarks for glad against the system malloc.
+ *
+ * 	cc -O2 -pthread glad_bench.c -o glad_bench
+ * 	./glad_bench [filter] | tee bench_output.txt
+ *
+ * Preload another allocator to compare it in the malloc rows:
+ *
+ * 	LD_PRELOAD=libjemalloc.so.2 ./glad_bench
+ * 	LD_PRELOAD=libmimalloc.so ./glad_bench
+ *
+ * Every benchmark runs in a child process of its own, so RSS and page faults
+ * are not inherited from the ones before it. ns/op is the best of BENCH_REPS
+ * timed runs; RSS (peak, KiB) and minor page faults are from the first run.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "glad.h"
+
+#define BENCH_REPS 5
+#define BENCH_ALLOCS (1L << 20)
+#define BENCH_ROUNDS 1000
+#define BENCH_ROUND_ALLOCS 1024
+#define BENCH_COPY_BYTES (64L * 1024L * 1024L)
+#define BENCH_THREADS 4
+
+typedef struct bench bench;
+struct bench {
+	const char* bn_name;
+	ptrdiff_t (*bn_run)(void);	/* runs the benchmark once, returns the number of ops */
+};
+
+/* time spent between bench_begin and bench_end, so that setup is not counted */
+double bench_ns;
+struct timespec bench_start;
+/* keeps the compiler from dropping allocations that are never read */
+volatile char bench_sink;
+
+void bench_begin(void)
+{
+	clock_gettime(CLOCK_MONOTONIC, &bench_start);
+}
+
+void bench_end(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	bench_ns += (now.tv_sec - bench_start.tv_sec) * 1e9 + (now.tv_nsec - bench_start.tv_nsec);
+}
+
+/* sizes and alignments cycled through by the mixed benchmarks */
+const ptrdiff_t bench_sizes[8] = { 8, 24, 48, 100, 256, 16, 1000, 64 };
+const ptrdiff_t bench_aligns[4] = { 8, 16, 32, 64 };
+
+typedef struct {
+	int id;
+	char payload[60];
+} bench_record;
+
+/* small fixed-size allocations */
+ptrdiff_t bench_small_glad(void)
+{
+	arena ar = {0};
+	bench_begin();
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS; ++i) {
+		char* p = (char*)arena_alloc(&ar, 32, 8, 0);
+		p[0] = (char)i;
+	}
+	arena_free(&ar, 0);
+	bench_end();
+	return BENCH_ALLOCS;
+}
+
+ptrdiff_t bench_small_malloc(void)
+{
+	char** ptrs = (char**)malloc(BENCH_ALLOCS * sizeof *ptrs);
+	bench_begin();
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS; ++i) {
+		ptrs[i] = (char*)malloc(32);
+		ptrs[i][0] = (char)i;
+	}
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS; ++i)
+		free(ptrs[i]);
+	bench_end();
+	free(ptrs);
+	return BENCH_ALLOCS;
+}
+
+/* mixed sizes and alignments */
+ptrdiff_t bench_mixed_glad(void)
+{
+	arena ar = {0};
+	bench_begin();
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS; ++i) {
+		char* p = (char*)arena_alloc(&ar, bench_sizes[i & 7], bench_aligns[(i >> 3) & 3], 0);
+		p[0] = (char)i;
+	}
+	arena_free(&ar, 0);
+	bench_end();
+	return BENCH_ALLOCS;
+}
+
+ptrdiff_t bench_mixed_malloc(void)
+{
+	void** ptrs = (void**)malloc(BENCH_ALLOCS * sizeof *ptrs);
+	bench_begin();
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS; ++i) {
+		if (posix_memalign(&ptrs[i], bench_aligns[(i >> 3) & 3], bench_sizes[i & 7]))
+			abort();
+		((char*)ptrs[i])[0] = (char)i;
+	}
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS; ++i)
+		free(ptrs[i]);
+	bench_end();
+	free(ptrs);
+	return BENCH_ALLOCS;
+}
+
+/* glad_push of a small record, against malloc and memcpy */
+ptrdiff_t bench_push_glad(void)
+{
+	arena ar = {0};
+	bench_record record = { 1, "payload" };
+	bench_begin();
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS; ++i) {
+		record.id = (int)i;
+		glad_push(&ar, bench_record, &record, 1, 0);
+	}
+	arena_free(&ar, 0);
+	bench_end();
+	return BENCH_ALLOCS;
+}
+
+ptrdiff_t bench_push_malloc(void)
+{
+	bench_record** ptrs = (bench_record**)malloc(BENCH_ALLOCS * sizeof *ptrs);
+	bench_record record = { 1, "payload" };
+	bench_begin();
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS; ++i) {
+		record.id = (int)i;
+		ptrs[i] = (bench_record*)malloc(sizeof record);
+		memcpy(ptrs[i], &record, sizeof record);
+	}
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS; ++i)
+		free(ptrs[i]);
+	bench_end();
+	free(ptrs);
+	return BENCH_ALLOCS;
+}
+
+/* per-request style cycles: allocate a batch, throw it all away, repeat */
+ptrdiff_t bench_reset_glad(void)
+{
+	arena ar = {0};
+	bench_begin();
+	for (int round = 0; round < BENCH_ROUNDS; ++round) {
+		for (int i = 0; i < BENCH_ROUND_ALLOCS; ++i) {
+			char* p = (char*)arena_alloc(&ar, 64, 8, 0);
+			p[0] = (char)i;
+		}
+		arena_reset(&ar);
+	}
+	bench_end();
+	arena_free(&ar, 0);
+	return (ptrdiff_t)BENCH_ROUNDS * BENCH_ROUND_ALLOCS;
+}
+
+ptrdiff_t bench_reset_malloc(void)
+{
+	char* ptrs[BENCH_ROUND_ALLOCS];
+	bench_begin();
+	for (int round = 0; round < BENCH_ROUNDS; ++round) {
+		for (int i = 0; i < BENCH_ROUND_ALLOCS; ++i) {
+			ptrs[i] = (char*)malloc(64);
+			ptrs[i][0] = (char)i;
+		}
+		for (int i = 0; i < BENCH_ROUND_ALLOCS; ++i)
+			free(ptrs[i]);
+	}
+	bench_end();
+	return (ptrdiff_t)BENCH_ROUNDS * BENCH_ROUND_ALLOCS;
+}
+
+/* fills an arena with BENCH_COPY_BYTES spread over geometrically growing chunks */
+void bench_fill(arena* ar)
+{
+	for (ptrdiff_t used = 0; used < BENCH_COPY_BYTES; used += 4000)
+		memset(arena_alloc(ar, 4000, 8, 0), 1, 4000);
+}
+
+/* one op is one call over BENCH_COPY_BYTES of data */
+ptrdiff_t bench_coalesce_glad(void)
+{
+	arena ar = {0};
+	bench_fill(&ar);
+	bench_begin();
+	bench_sink = *(char*)arena_crop_and_coalesce(&ar, 0);
+	bench_end();
+	arena_free(&ar, 0);
+	return 1;
+}
+
+ptrdiff_t bench_copy_glad(void)
+{
+	arena src = {0}, dst = {0};
+	bench_fill(&src);
+	bench_begin();
+	arena_copy(&dst, &src, 0);
+	bench_end();
+	bench_sink = dst.ar_head->ch_data[0];
+	arena_free(&dst, 0);
+	arena_free(&src, 0);
+	return 1;
+}
+
+#ifdef GLAD_THREADS
+/* contention: BENCH_THREADS threads allocating BENCH_ALLOCS in total */
+carena bench_carena;
+_Thread_local tarena bench_tarena;
+
+void* bench_carena_worker(void* arg)
+{
+	(void)arg;
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS / BENCH_THREADS; ++i) {
+		char* p = (char*)carena_alloc(&bench_carena, 32, 8, 0);
+		p[0] = (char)i;
+	}
+	return 0;
+}
+
+void* bench_tarena_worker(void* arg)
+{
+	(void)arg;
+	bench_tarena.ta_parent = &bench_carena;
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS / BENCH_THREADS; ++i) {
+		char* p = (char*)tarena_alloc(&bench_tarena, 32, 8, 0);
+		p[0] = (char)i;
+	}
+	return 0;
+}
+
+void* bench_malloc_worker(void* arg)
+{
+	char** ptrs = (char**)arg;
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS / BENCH_THREADS; ++i) {
+		ptrs[i] = (char*)malloc(32);
+		ptrs[i][0] = (char)i;
+	}
+	for (ptrdiff_t i = 0; i < BENCH_ALLOCS / BENCH_THREADS; ++i)
+		free(ptrs[i]);
+	return 0;
+}
+
+ptrdiff_t bench_threads_run(void* (*worker)(void*), char** ptrs)
+{
+	pthread_t threads[BENCH_THREADS];
+	bench_begin();
+	for (int i = 0; i < BENCH_THREADS; ++i)
+		pthread_create(&threads[i], 0, worker, ptrs ? ptrs + i * (BENCH_ALLOCS / BENCH_THREADS) : 0);
+	for (int i = 0; i < BENCH_THREADS; ++i)
+		pthread_join(threads[i], 0);
+	bench_end();
+	return BENCH_ALLOCS;
+}
+
+ptrdiff_t bench_threads_carena(void)
+{
+	carena_init(&bench_carena, 0);
+	ptrdiff_t ops = bench_threads_run(bench_carena_worker, 0);
+	carena_free(&bench_carena, 0);
+	return ops;
+}
+
+ptrdiff_t bench_threads_tarena(void)
+{
+	carena_init(&bench_carena, 0);
+	ptrdiff_t ops = bench_threads_run(bench_tarena_worker, 0);
+	carena_free(&bench_carena, 0);
+	return ops;
+}
+
+ptrdiff_t bench_threads_malloc(void)
+{
+	char** ptrs = (char**)malloc(BENCH_ALLOCS * sizeof *ptrs);
+	ptrdiff_t ops = bench_threads_run(bench_malloc_worker, ptrs);
+	free(ptrs);
+	return ops;
+}
+#endif
+
+const bench benches[] = {
+	{ "small_fixed/glad", bench_small_glad },
+	{ "small_fixed/malloc", bench_small_malloc },
+	{ "mixed/glad", bench_mixed_glad },
+	{ "mixed/malloc", bench_mixed_malloc },
+	{ "push/glad", bench_push_glad },
+	{ "push/malloc", bench_push_malloc },
+	{ "reset_cycle/glad", bench_reset_glad },
+	{ "reset_cycle/malloc", bench_reset_malloc },
+	{ "crop_and_coalesce_64M/glad", bench_coalesce_glad },
+	{ "copy_64M/glad", bench_copy_glad },
+#ifdef GLAD_THREADS
+	{ "threads/carena", bench_threads_carena },
+	{ "threads/tarena", bench_threads_tarena },
+	{ "threads/malloc", bench_threads_malloc },
+#endif
+};
+
+/* runs b in a child process and prints its row */
+void bench_report(const bench* b)
+{
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid < 0) {
+		perror("fork");
+		return;
+	}
+	if (pid > 0) {
+		int status = 0;
+		waitpid(pid, &status, 0);
+		if (!WIFEXITED(status) || WEXITSTATUS(status))
+			printf("%-32s failed\n", b->bn_name);
+		return;
+	}
+
+	bench_ns = 0;
+	ptrdiff_t ops = b->bn_run();
+	double best = bench_ns;
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	for (int rep = 1; rep < BENCH_REPS; ++rep) {
+		bench_ns = 0;
+		b->bn_run();
+		if (bench_ns < best)
+			best = bench_ns;
+	}
+
+	printf("%-32s %12.2f %12td %12ld %12ld\n", b->bn_name, best / ops, ops,
+			usage.ru_maxrss, usage.ru_minflt);
+	fflush(stdout);
+	_exit(0);
+}
+
+int main(int argc, char** argv)
+{
+	const char* filter = argc > 1 ? argv[1] : 0;
+	const char* preload = getenv("LD_PRELOAD");
+	printf("malloc: %s\n", preload && *preload ? preload : "system");
+	printf("%-32s %12s %12s %12s %12s\n", "benchmark", "ns/op", "ops", "rss KiB", "faults");
+
+	for (size_t i = 0; i < sizeof benches / sizeof *benches; ++i) {
+		if (filter && !strstr(benches[i].bn_name, filter))
+			continue;
+		bench_report(&benches[i]);
+	}
+	return 0;
+}
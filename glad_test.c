@@ -1,9 +1,22 @@
+/* The tests are built both with the compiler's default and with -std=c11,
+ * which hides mkstemp, fork and the like from the system headers. */
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
 #include <stdint.h>
 #include "glad.h"
 
+#ifdef GLAD_THREADS
+#include <pthread.h>
+#endif
+
+#include <sys/wait.h>
+
+#ifdef GLAD_GUARD
+#include <signal.h>
+#endif
+
 // Helper function for running individual tests
 void run_test(const char* test_name, void (*test_func)()) {
     printf("Running %s...\n", test_name);
@@ -92,6 +105,108 @@ void test_arena_get_size_multiple_chunks() {
     arena_free(&ar, 0);
 }
 
+// The totals that arena_get_size and arena_get_mapped keep, counted the slow way
+ptrdiff_t walk_size(arena* ar) {
+    arena_sync(ar);
+    ptrdiff_t size = 0;
+    for (chunk* ch = ar->ar_head; ch; ch = ch->ch_next) size += ch->ch_offset;
+    return size;
+}
+
+ptrdiff_t walk_mapped(arena* ar) {
+    ptrdiff_t mapped = 0;
+    for (chunk* ch = ar->ar_head; ch; ch = ch->ch_next) mapped += CHUNK_ALLOC_SIZE(ch->ch_size);
+    return mapped;
+}
+
+int totals_match(arena* ar) {
+    return arena_get_size(ar) == walk_size(ar) && arena_get_mapped(ar) == walk_mapped(ar);
+}
+
+// Test that the running totals follow every way chunks change
+void test_arena_get_size_running() {
+    arena ar;
+    arena_init(&ar, 0);
+    for (int i = 0; i < 5; ++i) {
+        arena_alloc(&ar, DEFAULT_CHUNK_SIZE / 2 + 100 * i, 8, 0);
+        assert(totals_match(&ar));
+    }
+    arena_savepoint sp = arena_mark(&ar);
+    arena_alloc(&ar, 3 * DEFAULT_CHUNK_SIZE, 1, 0);
+    arena_alloc(&ar, 10, 1, FIRSTFIT);
+    assert(totals_match(&ar));
+    arena_rewind(&ar, sp);
+    assert(totals_match(&ar));
+
+    // Spare chunks after a reset are moved into again
+    arena_reset(&ar);
+    assert(arena_get_size(&ar) == 0 && totals_match(&ar));
+    for (int i = 0; i < 4; ++i) arena_alloc(&ar, DEFAULT_CHUNK_SIZE / 2, 1, 0);
+    arena_alloc(&ar, 64, 1, FIRSTFIT);
+    assert(totals_match(&ar));
+
+    arena copy;
+    arena_init(&copy, 0);
+    arena_copy(&copy, &ar, 0);
+    assert(totals_match(&copy) && arena_get_size(&copy) == arena_get_size(&ar));
+    arena_free(&copy, 0);
+    assert(arena_get_size(&copy) == 0 && arena_get_mapped(&copy) == 0);
+
+    assert(arena_compact(&ar, 0, 8, 0));
+    assert(totals_match(&ar));
+    arena_clear(&ar);
+    assert(totals_match(&ar));
+    arena_free(&ar, 0);
+    assert(arena_get_mapped(&ar) == 0);
+}
+
+// Test arena_contains on indexed and single-chunk arenas
+void test_arena_contains() {
+    // chunks that stop growing, so there are many of them
+    arena_config fixed = { .ac_max_chunk = DEFAULT_CHUNK_SIZE };
+    arena ar;
+    arena_init(&ar, &fixed);
+    int local = 0;
+    assert(!arena_contains(&ar, &ar) && !arena_contains(0, &local));
+
+    char* first = (char*)arena_alloc(&ar, 100, 1, 0);
+    assert(arena_contains(&ar, first) && !arena_contains(&ar, &local));
+    char* regions[40];
+    for (int i = 0; i < 40; ++i) {
+        regions[i] = (char*)arena_alloc(&ar, DEFAULT_CHUNK_SIZE / 2, 1, 0);
+        assert(regions[i]);
+    }
+    assert(ar.ar_range_count > 20);
+    for (int i = 0; i < 40; ++i) {
+        assert(arena_contains(&ar, regions[i]));
+        assert(arena_contains(&ar, regions[i] + DEFAULT_CHUNK_SIZE / 2 - 1));
+    }
+    for (chunk* ch = ar.ar_head; ch; ch = ch->ch_next) {
+        assert(arena_contains(&ar, ch->ch_data + ch->ch_size - 1));
+        assert(!arena_contains(&ar, ch));
+    }
+
+    // Memory that went back to the kernel no longer counts
+    arena_savepoint sp = arena_mark(&ar);
+    char* big = (char*)arena_alloc(&ar, 4 * DEFAULT_CHUNK_SIZE, 1, 0);
+    assert(arena_contains(&ar, big));
+    arena_rewind(&ar, sp);
+    assert(!arena_contains(&ar, big) && arena_contains(&ar, first));
+
+    char* data = (char*)arena_compact(&ar, 0, 1, 0);
+    assert(arena_contains(&ar, data) && !arena_contains(&ar, first));
+    arena_free(&ar, 0);
+    assert(!arena_contains(&ar, data));
+
+    // A RESERVE arena is one range
+    arena_config config = { .ac_flags = RESERVE };
+    arena_init(&ar, &config);
+    char* p = (char*)arena_alloc(&ar, 1 << 20, 1, 0);
+    assert(arena_contains(&ar, p) && arena_contains(&ar, p + (1 << 20) - 1));
+    assert(!arena_contains(&ar, &local));
+    arena_free(&ar, 0);
+}
+
 // Test arena_push with normal, large, and null data
 void test_arena_push_basic() {
     arena ar = {0};
@@ -146,14 +261,289 @@ void test_arena_crop_and_coalesce_large() {
     arena_push(&ar, data, sizeof data, alignof(char), 0);
     arena_push(&ar, data, sizeof data, alignof(char), 0);
     arena_push(&ar, data, sizeof data, alignof(char), 0);
+    assert(ar.ar_head != ar.ar_tail);
     char* coalesced_data = (char*) arena_crop_and_coalesce(&ar, ZEROMEM);
     assert(coalesced_data);
-    for (size_t i = 0; i < sizeof(data); ++i) {
+    // Byte data is packed back to back, without padding at the old chunk boundaries
+    assert(arena_get_size(&ar) == 3 * (ptrdiff_t)sizeof(data));
+    for (size_t i = 0; i < 3 * sizeof(data); ++i) {
         assert(coalesced_data[i] == 7);
     }
     arena_free(&ar, 0);
 }
 
+typedef struct reloc_node {
+    struct reloc_node* next;
+    int value;
+} reloc_node;
+
+// Pointers are fixed up through the relocation table, and alignment survives the move
+void test_arena_compact_relocs() {
+    arena ar = {0};
+    reloc_node* list = 0;
+    unsigned char* pages[20];
+    for (int i = 0; i < 20000; ++i) {
+        reloc_node* node = glad_new(&ar, reloc_node, 1);
+        node->next = list;
+        node->value = i;
+        list = node;
+        if (i % 1000 == 0) {
+            pages[i / 1000] = (unsigned char*)arena_alloc(&ar, 100, 4096, 0);
+            memset(pages[i / 1000], i / 1000, 100);
+        }
+    }
+    assert(ar.ar_head != ar.ar_tail);
+
+    int outside = 0;
+    arena_relocs relocs;
+    assert(!arena_compact(&ar, &relocs, 3, 0) && !relocs.rs_entries);
+    assert(ar.ar_head != ar.ar_tail);
+    assert(arena_compact(&ar, &relocs, 4096, 0));
+    assert(ar.ar_head == ar.ar_tail);
+    assert(relocs.rs_count > 1);
+    assert(arena_relocate(&relocs, &outside) == &outside);
+
+    list = (reloc_node*)arena_relocate(&relocs, list);
+    for (reloc_node* node = list; node; node = node->next)
+        node->next = (reloc_node*)arena_relocate(&relocs, node->next);
+    int expect = 19999;
+    for (reloc_node* node = list; node; node = node->next) {
+        assert((uintptr_t)node % alignof(reloc_node) == 0);
+        assert(node->value == expect--);
+    }
+    assert(expect == -1);
+
+    // The page-aligned blocks are still page-aligned
+    for (int b = 0; b < 20; ++b) {
+        pages[b] = (unsigned char*)arena_relocate(&relocs, pages[b]);
+        assert((uintptr_t)pages[b] % 4096 == 0);
+        assert(pages[b][0] == b && pages[b][99] == b);
+    }
+    arena_relocs_free(&relocs);
+    assert(!relocs.rs_entries && !relocs.rs_count);
+    arena_free(&ar, 0);
+}
+
+// Fills an arena with small chunks and one larger than DEFAULT_COPY_SLICE
+void fill_parallel_arena(arena* ar, unsigned seed) {
+    arena_init(ar, 0);
+    for (int i = 0; i < 200; ++i) {
+        ptrdiff_t size = 1000 + (i * 7919) % 60000;
+        unsigned char* block = (unsigned char*)arena_alloc(ar, size, 1, 0);
+        for (ptrdiff_t j = 0; j < size; ++j) block[j] = (unsigned char)(seed + i + j);
+    }
+    ptrdiff_t size = 2 * DEFAULT_COPY_SLICE + 12345;
+    unsigned char* huge = (unsigned char*)arena_alloc(ar, size, 1, 0);
+    for (ptrdiff_t j = 0; j < size; j += 4096) huge[j] = (unsigned char)(seed + j / 4096);
+    huge[size - 1] = 0x5A;
+}
+
+// Collects the tasks a custom executor is given and runs them backwards
+typedef struct task_log {
+    ptrdiff_t calls;
+    ptrdiff_t tasks;
+} task_log;
+
+void run_backwards(void* data, void (*task)(void*, ptrdiff_t), void* arg, ptrdiff_t count) {
+    task_log* log = (task_log*)data;
+    log->calls += 1;
+    log->tasks += count;
+    for (ptrdiff_t i = count - 1; i >= 0; --i) task(arg, i);
+}
+
+// Test that the parallel variants give the same result as the serial ones
+void test_arena_copy_parallel() {
+    arena src, serial, threaded, custom;
+    fill_parallel_arena(&src, 3);
+    arena_init(&serial, 0);
+    arena_copy(&serial, &src, 0);
+
+    glad_executor threads = { .ex_threads = 4 };
+    arena_init(&threaded, 0);
+    arena_copy_parallel(&threaded, &src, 0, &threads);
+
+    // more tasks than chunks: the huge chunk is split into slices
+    task_log log = {0};
+    glad_executor backwards = { .ex_run = run_backwards, .ex_data = &log };
+    arena_init(&custom, 0);
+    arena_copy_parallel(&custom, &src, 0, &backwards);
+    int chunks = 0;
+    for (chunk* ch = src.ar_head; ch; ch = ch->ch_next) ++chunks;
+    assert(log.calls == 1 && log.tasks >= chunks + 2);
+
+    arena* copies[] = { &serial, &threaded, &custom };
+    for (int c = 0; c < 3; ++c) {
+        chunk* a = src.ar_head;
+        chunk* b = copies[c]->ar_head;
+        for (; a && b; a = a->ch_next, b = b->ch_next) {
+            assert(a->ch_offset == b->ch_offset);
+            assert(!memcmp(a->ch_data, b->ch_data, a->ch_offset));
+        }
+        assert(!a && !b);
+        assert(arena_get_size(copies[c]) == arena_get_size(&src));
+        arena_free(copies[c], 0);
+    }
+    arena_free(&src, 0);
+}
+
+void test_arena_compact_parallel() {
+    arena serial, threaded;
+    fill_parallel_arena(&serial, 9);
+    fill_parallel_arena(&threaded, 9);
+    // followed through the table; both arenas hold one so they still match
+    reloc_node* node = glad_new(&serial, reloc_node);
+    node->value = 77;
+    node = glad_new(&threaded, reloc_node);
+    node->value = 77;
+
+    arena_relocs serial_relocs, threaded_relocs;
+    char* serial_data = (char*)arena_compact(&serial, &serial_relocs, alignof(reloc_node), 0);
+    glad_executor threads = { .ex_threads = 0 };
+    char* threaded_data = (char*)arena_compact_parallel(&threaded, &threaded_relocs, alignof(reloc_node), 0, &threads);
+    assert(serial_data && threaded_data);
+    assert(threaded.ar_head == threaded.ar_tail);
+    assert(threaded_relocs.rs_count == serial_relocs.rs_count);
+    node = (reloc_node*)arena_relocate(&threaded_relocs, node);
+    assert(node->value == 77);
+    assert(serial.ar_head->ch_offset == threaded.ar_head->ch_offset);
+    assert(!memcmp(serial_data, threaded_data, serial.ar_head->ch_offset));
+    arena_relocs_free(&serial_relocs);
+    arena_relocs_free(&threaded_relocs);
+    arena_free(&serial, 0);
+    arena_free(&threaded, 0);
+}
+
+// Finalizers append their object's tag to a shared log
+typedef struct fin_log {
+    int order[16];
+    int count;
+} fin_log;
+
+typedef struct fin_object {
+    fin_log* log;
+    int tag;
+} fin_object;
+
+void log_finalizer(void* object) {
+    fin_object* obj = (fin_object*)object;
+    obj->log->order[obj->log->count++] = obj->tag;
+}
+
+fin_object* new_fin_object(arena* ar, fin_log* log, int tag) {
+    fin_object* obj = glad_new_fin(ar, fin_object, log_finalizer);
+    assert(obj && obj->tag == 0);
+    obj->log = log;
+    obj->tag = tag;
+    return obj;
+}
+
+// Test that finalizers run last first on reset, clear, free and rewind
+void test_arena_finalizers() {
+    arena ar;
+    arena_init(&ar, 0);
+    fin_log log = {0};
+    for (int i = 1; i <= 3; ++i) new_fin_object(&ar, &log, i);
+    // the records live in the arena, next to their objects
+    assert(arena_contains(&ar, ar.ar_finalizers));
+    arena_reset(&ar);
+    assert(log.count == 3 && log.order[0] == 3 && log.order[1] == 2 && log.order[2] == 1);
+    assert(!ar.ar_finalizers);
+
+    log.count = 0;
+    new_fin_object(&ar, &log, 4);
+    arena_savepoint sp = arena_mark(&ar);
+    new_fin_object(&ar, &log, 5);
+    fin_object* outside = glad_new(&ar, fin_object);
+    outside->log = &log;
+    outside->tag = 6;
+    assert(arena_on_free(&ar, log_finalizer, outside));
+    arena_rewind(&ar, sp);
+    assert(log.count == 2 && log.order[0] == 6 && log.order[1] == 5);
+
+    arena_clear(&ar);
+    assert(log.count == 3 && log.order[2] == 4);
+    new_fin_object(&ar, &log, 7);
+    // alignments arena_alloc would refuse register nothing
+    ptrdiff_t bad_alignments[] = { 0, -8, 3, 24 };
+    for (int i = 0; i < 4; ++i)
+        assert(!arena_alloc_finalized(&ar, sizeof(fin_object), bad_alignments[i], log_finalizer, 0));
+    assert(((fin_object*)ar.ar_finalizers->fz_object)->tag == 7);
+    arena_free(&ar, 0);
+    assert(log.count == 4 && log.order[3] == 7);
+    assert(!arena_on_free(&ar, 0, outside));
+}
+
+// Test that the finalizer list follows its records through arena_compact
+void test_arena_finalizers_compact() {
+    arena ar;
+    arena_init(&ar, 0);
+    fin_log log = {0};
+    for (int i = 1; i <= 3; ++i) {
+        new_fin_object(&ar, &log, i);
+        // each chunk ends on an odd byte, so packing would misalign the next record
+        arena_alloc(&ar, 1, 1, 0);
+        arena_alloc(&ar, DEFAULT_CHUNK_SIZE, 1, 0);
+    }
+    assert(ar.ar_head != ar.ar_tail);
+    // the records stay aligned even when the caller's data needs none
+    assert(arena_compact(&ar, 0, 1, 0));
+    assert(ar.ar_head == ar.ar_tail);
+    assert(arena_contains(&ar, ar.ar_finalizers));
+    for (arena_finalizer* node = ar.ar_finalizers; node; node = node->fz_next)
+        assert((uintptr_t)node % alignof(arena_finalizer) == 0);
+    arena_free(&ar, 0);
+    assert(log.count == 3 && log.order[0] == 3 && log.order[1] == 2 && log.order[2] == 1);
+}
+
+// Test arena_alloc_batch and glad_new_n
+void test_arena_alloc_batch() {
+    arena ar = {0};
+    arena_request requests[] = { {1, 1}, {8, 8}, {100, 64}, {3, 2}, {4096, 4096}, {24, 8} };
+    ptrdiff_t count = sizeof requests / sizeof requests[0];
+    void* out[6];
+
+    // Fill the first chunk so that the batch has to move on to the next one
+    char* filler = (char*)arena_alloc(&ar, DEFAULT_CHUNK_SIZE - 256, 1, 0);
+    memset(filler, 0xEE, DEFAULT_CHUNK_SIZE - 256);
+    assert(arena_alloc_batch(&ar, requests, count, out, ZEROMEM));
+    assert(ar.ar_head != ar.ar_tail);
+    for (ptrdiff_t i = 0; i < count; ++i) {
+        unsigned char* region = (unsigned char*)out[i];
+        assert((uintptr_t)region % requests[i].rq_alignment == 0);
+        assert(region >= (unsigned char*)ar.ar_tail->ch_data);
+        assert(region + requests[i].rq_size <= (unsigned char*)ar.ar_tail->ch_data + ar.ar_tail->ch_offset);
+        if (i + 1 < count) assert(region + requests[i].rq_size <= (unsigned char*)out[i + 1]);
+        for (ptrdiff_t j = 0; j < requests[i].rq_size; ++j) assert(region[j] == 0);
+    }
+
+    // A bad request fails the whole batch
+    ptrdiff_t size = arena_get_size(&ar);
+    arena_request bad[] = { {16, 16}, {16, 3} };
+    out[0] = out[1] = &size;
+    assert(!arena_alloc_batch(&ar, bad, 2, out, 0));
+    assert(arena_get_size(&ar) == size);
+    assert(out[0] == &size && out[1] == &size);
+    arena_free(&ar, 0);
+}
+
+void test_glad_new_n() {
+    arena ar = {0};
+    void* out[1000];
+    reloc_node* nodes = glad_new_n(&ar, reloc_node, 1000, out);
+    assert(nodes);
+    for (int i = 0; i < 1000; ++i) {
+        assert(out[i] == &nodes[i]);
+        assert(nodes[i].next == 0 && nodes[i].value == 0);
+    }
+    int* ints = glad_new_n(&ar, int, 16, 0, 0);
+    assert(ints && (uintptr_t)ints % alignof(int) == 0);
+    assert(!glad_new_n(&ar, int, 0, out));
+#ifdef GLAD_STATS
+    assert(arena_get_stats(&ar).st_allocs == 1016);
+#endif
+    arena_free(&ar, 0);
+}
+
 // Test arena_copy with valid and empty arenas
 void test_arena_copy_basic() {
     arena src = {0}, dst = {0};
@@ -182,6 +572,50 @@ void test_arena_clear() {
     arena_free(&ar, 0);
 }
 
+// arena_clear zeroes everything handed out, including memory past the offset that a reset left dirty
+void test_arena_clear_used_prefix() {
+    arena ar = {0};
+    unsigned char* data = (unsigned char*)arena_alloc(&ar, 1024, 8, 0);
+    memset(data, 0xAB, 1024);
+    arena_reset(&ar);
+    arena_alloc(&ar, 16, 8, 0);
+    arena_clear(&ar);
+    assert(ar.ar_head->ch_offset == 0 && ar.ar_head->ch_dirty == 0);
+    unsigned char* again = (unsigned char*)arena_alloc(&ar, 1024, 8, 0);
+    assert(again == data);
+    for (size_t i = 0; i < 1024; ++i) {
+        assert(again[i] == 0);
+    }
+    arena_free(&ar, 0);
+}
+
+// DISCARD arenas get zero pages back from the kernel for large chunks
+void test_arena_clear_discard() {
+    arena ar;
+    arena_config config = { .ac_min_chunk = 4 * 1024 * 1024, .ac_flags = DISCARD };
+    arena_init(&ar, &config);
+
+    size_t size = 2 * 1024 * 1024;
+    unsigned char* data = (unsigned char*)arena_alloc(&ar, size, 8, 0);
+    memset(data, 0xAB, size);
+    arena_clear(&ar);
+    assert(ar.ar_head->ch_dirty == 0);
+    unsigned char* again = (unsigned char*)arena_alloc(&ar, size, 8, 0);
+    assert(again == data);
+    for (size_t i = 0; i < size; ++i) {
+        assert(again[i] == 0);
+    }
+
+    // a small clear goes through memset
+    arena_clear(&ar);
+    again = (unsigned char*)arena_alloc(&ar, 64, 8, 0);
+    memset(again, 0xCD, 64);
+    arena_clear(&ar);
+    again = (unsigned char*)arena_alloc(&ar, 64, 8, 0);
+    assert(again[0] == 0 && again[63] == 0);
+    arena_free(&ar, 0);
+}
+
 // Test arena_reset with edge and normal cases
 void test_arena_reset() {
     arena ar = {0};
@@ -294,6 +728,1300 @@ void test_arena_alloc_alignment_fallback_chunk_allocation() {
     arena_free(&ar, 0);
 }
 
+// Test the bump-pointer fast path and chunk reuse
+void test_arena_alloc_bump_contiguous() {
+    arena ar = {0};
+    char* first = (char*)arena_alloc(&ar, 16, 16, 0);
+    char* second = (char*)arena_alloc(&ar, 16, 16, 0);
+    assert(first && second);
+    assert(second == first + 16);
+    assert(ar.ar_curr == ar.ar_head);
+    assert(arena_get_size(&ar) >= 32);
+    arena_free(&ar, 0);
+}
+
+void test_arena_alloc_reset_reuses_chunks() {
+    arena ar = {0};
+    char* first = (char*)arena_alloc(&ar, 64, 8, 0);
+    arena_alloc(&ar, DEFAULT_CHUNK_SIZE, 8, 0); // spills into a second chunk
+    chunk* second = ar.ar_tail;
+    assert(second != ar.ar_head);
+
+    arena_reset(&ar);
+    assert(arena_get_size(&ar) == 0);
+    assert((char*)arena_alloc(&ar, 64, 8, 0) == first);
+
+    // The head is too small for this one, so the spare chunk is used instead of a new one
+    void* big = arena_alloc(&ar, DEFAULT_CHUNK_SIZE, 8, 0);
+    assert(big);
+    assert(ar.ar_curr == second && ar.ar_tail == second);
+    arena_free(&ar, 0);
+}
+
+void test_arena_alloc_firstfit() {
+    arena ar = {0};
+    arena_alloc(&ar, 64, 8, 0);
+    arena_alloc(&ar, DEFAULT_CHUNK_SIZE, 8, 0);
+    chunk* head = ar.ar_head;
+    assert(ar.ar_curr != head);
+
+    // Without FIRSTFIT, small allocations stay in the current chunk
+    void* tail_mem = arena_alloc(&ar, 32, 32, 0);
+    assert(tail_mem);
+    assert((char*)tail_mem >= ar.ar_curr->ch_data);
+
+    // With FIRSTFIT, the free space left in the head chunk is back-filled
+    char* head_mem = (char*)arena_alloc(&ar, 32, 32, FIRSTFIT);
+    assert(head_mem);
+    assert(head_mem >= head->ch_data && head_mem < head->ch_data + head->ch_size);
+    assert(((uintptr_t)head_mem % 32) == 0);
+    assert(ar.ar_curr != head);
+    arena_free(&ar, 0);
+}
+
+// Test the chunk growth policy
+void test_arena_growth_default() {
+    arena ar = {0};
+    arena_alloc(&ar, 16, 8, 0);
+    // Small arenas only map a small first chunk
+    assert(CHUNK_ALLOC_SIZE(ar.ar_head->ch_size) == DEFAULT_CHUNK_SIZE);
+    arena_free(&ar, 0);
+}
+
+void test_arena_growth_geometric() {
+    arena ar;
+    arena_config config = { .ac_min_chunk = 16 * 1024, .ac_max_chunk = 64 * 1024, .ac_growth = 2 };
+    arena_init(&ar, &config);
+
+    // Fill several chunks with allocations that never fit in the leftover space
+    for (int i = 0; i < 12; ++i) {
+        assert(arena_alloc(&ar, 8 * 1024, 8, 0));
+    }
+
+    ptrdiff_t expected[] = { 16 * 1024, 32 * 1024, 64 * 1024, 64 * 1024 };
+    chunk* cursor = ar.ar_head;
+    for (int i = 0; cursor; ++i, cursor = cursor->ch_next) {
+        ptrdiff_t mapped = CHUNK_ALLOC_SIZE(cursor->ch_size);
+        assert(mapped == expected[i < 3 ? i : 3]);
+    }
+
+    // Requests larger than the cap get a chunk of their own
+    void* big = arena_alloc(&ar, 256 * 1024, 8, 0);
+    assert(big);
+    assert(ar.ar_tail->ch_size >= 256 * 1024);
+    assert(ar.ar_next_chunk == 64 * 1024);
+    arena_free(&ar, 0);
+    assert(ar.ar_min_chunk == 16 * 1024); // the policy survives arena_free
+}
+
+// Test that ZEROMEM only zeroes memory that was handed out before
+void test_arena_alloc_zeromem_fresh() {
+    arena ar = {0};
+    unsigned char* data = (unsigned char*)arena_alloc(&ar, 4096, 8, ZEROMEM);
+    assert(data);
+    assert(ar.ar_head->ch_dirty == 0);
+    for (size_t i = 0; i < 4096; ++i) {
+        assert(data[i] == 0);
+    }
+    arena_free(&ar, 0);
+}
+
+void test_arena_alloc_zeromem_after_reset() {
+    arena ar = {0};
+    unsigned char* data = (unsigned char*)arena_alloc(&ar, 256, 8, 0);
+    memset(data, 0xAB, 256);
+    arena_reset(&ar);
+    assert(ar.ar_head->ch_dirty == 256);
+
+    // Without ZEROMEM the old contents are still there
+    unsigned char* reused = (unsigned char*)arena_alloc(&ar, 64, 8, 0);
+#if defined(GLAD_GUARD) && !defined(GLAD_ASAN)
+    // unless the guarded backend filled them with its poison pattern
+    assert(reused == data && reused[0] == GLAD_POISON_BYTE);
+#else
+    assert(reused == data && reused[0] == 0xAB);
+#endif
+
+    // With ZEROMEM the reused part is cleared, even across the dirty boundary
+    unsigned char* zeroed = (unsigned char*)arena_alloc(&ar, 512, 8, ZEROMEM);
+    assert(zeroed == data + 64);
+    for (size_t i = 0; i < 512; ++i) {
+        assert(zeroed[i] == 0);
+    }
+    arena_free(&ar, 0);
+}
+
+// Test streaming copies at every alignment and around the size threshold
+void test_glad_copy() {
+    ptrdiff_t size = 4 * GLAD_STREAM_SIZE + 4096;
+    unsigned char* src = (unsigned char*)malloc(size);
+    unsigned char* dst = (unsigned char*)malloc(size);
+    assert(src && dst);
+    for (ptrdiff_t i = 0; i < size; ++i) src[i] = (unsigned char)(i * 7 + i / 4096);
+
+    ptrdiff_t lengths[] = { 0, 1, 100, GLAD_STREAM_SIZE - 1, GLAD_STREAM_SIZE, GLAD_STREAM_SIZE + 33, 3 * GLAD_STREAM_SIZE + 255 };
+    for (int src_off = 0; src_off < 64; src_off += 13) {
+        for (int dst_off = 0; dst_off < 64; dst_off += 7) {
+            for (size_t l = 0; l < sizeof lengths / sizeof *lengths; ++l) {
+                ptrdiff_t n = lengths[l];
+                memset(dst, 0xEE, dst_off + n + 64);
+                assert(glad_copy(dst + dst_off, src + src_off, n) == dst + dst_off);
+                assert(!memcmp(dst + dst_off, src + src_off, n));
+                // nothing is written around the destination
+                assert(dst_off == 0 || dst[dst_off - 1] == 0xEE);
+                for (int i = 0; i < 64; ++i) assert(dst[dst_off + n + i] == 0xEE);
+            }
+        }
+    }
+
+#ifdef GLAD_STREAM
+    // The kernels also take copies shorter than their alignment, for a small GLAD_STREAM_SIZE
+    for (int dst_off = 1; dst_off < 64; dst_off += 7) {
+        for (ptrdiff_t n = 0; n < 64; n += 5) {
+            for (int kernel = 0; kernel < 2; ++kernel) {
+                if (kernel ? !__builtin_cpu_supports("avx512f") : !__builtin_cpu_supports("avx2"))
+                    continue;
+                memset(dst, 0xEE, dst_off + n + 64);
+                if (kernel)
+                    glad_stream_avx512((char*)dst + dst_off, (const char*)src, n);
+                else
+                    glad_stream_avx2((char*)dst + dst_off, (const char*)src, n);
+                assert(!memcmp(dst + dst_off, src, n));
+                for (int i = 0; i < 64; ++i) assert(dst[dst_off + n + i] == 0xEE);
+            }
+        }
+    }
+#endif
+
+    // Large pushes and copies between arenas go through it
+    arena ar, copy;
+    arena_init(&ar, 0);
+    arena_init(&copy, 0);
+    unsigned char* pushed = (unsigned char*)arena_push(&ar, src + 3, 2 * GLAD_STREAM_SIZE + 5, 1, 0);
+    assert(pushed && !memcmp(pushed, src + 3, 2 * GLAD_STREAM_SIZE + 5));
+    arena_copy(&copy, &ar, 0);
+    assert(!memcmp(copy.ar_head->ch_data, ar.ar_head->ch_data, ar.ar_head->ch_offset));
+    arena_free(&ar, 0);
+    arena_free(&copy, 0);
+    free(src);
+    free(dst);
+}
+
+// Test that chunks are recycled through a chunk_cache
+void test_chunk_cache_reuse() {
+    chunk_cache cache = {0};
+    arena_config config = { .ac_cache = &cache };
+    arena ar;
+    arena_init(&ar, &config);
+
+    unsigned char* first = (unsigned char*)arena_alloc(&ar, 128, 8, 0);
+    memset(first, 0xCD, 128);
+    chunk* head = ar.ar_head;
+    arena_free(&ar, 0);
+    assert(cache.cc_head == head);
+    assert(cache.cc_bytes == (ptrdiff_t)CHUNK_ALLOC_SIZE(head->ch_size));
+
+    // A new arena on the same cache picks the chunk back up, and ZEROMEM still zeroes it
+    arena_init(&ar, &config);
+    unsigned char* second = (unsigned char*)arena_alloc(&ar, 128, 8, ZEROMEM);
+    assert(second == first);
+    for (size_t i = 0; i < 128; ++i) {
+        assert(second[i] == 0);
+    }
+    assert(!cache.cc_head && cache.cc_bytes == 0);
+    arena_free(&ar, 0);
+    cache_free(&cache);
+    assert(!cache.cc_head && cache.cc_bytes == 0);
+}
+
+void test_chunk_cache_high_water() {
+    chunk_cache cache = { .cc_max_bytes = DEFAULT_CHUNK_SIZE, .cc_madvise = 1 };
+    chunk* small = cache_alloc_chunk(&cache, 1024, 0);
+    chunk* large = cache_alloc_chunk(&cache, DEFAULT_CHUNK_SIZE, 0);
+    assert(small && large);
+    memset(small->ch_data, 1, 1024);
+    small->ch_offset = 1024;
+
+    cache_free_chunk(&cache, small);
+    cache_free_chunk(&cache, large); // past the high-water mark, so it gets unmapped
+    assert(cache.cc_head == small && !small->ch_next);
+    assert(small->ch_offset == 0 && small->ch_dirty >= 0);
+
+    // Requests the cached chunk can't hold map a new one
+    chunk* fresh = cache_alloc_chunk(&cache, 4096, 0);
+    assert(fresh && fresh != small);
+    free_chunk(fresh);
+    assert(cache_alloc_chunk(&cache, 512, 0) == small);
+    free_chunk(small);
+    cache_free(&cache);
+}
+
+// Test an arena whose chunks are a fixed set of registered buffers
+void test_cache_buffers() {
+    chunk_cache cache;
+    assert(cache_init_buffers(&cache, 60 * 1024, 4, 0) == 0);
+    assert(cache.cc_count == 4 && cache.cc_iovecs);
+    for (int i = 0; i < 4; ++i) {
+        assert(cache.cc_iovecs[i].iov_len >= 60 * 1024);
+        if (i > 0) assert((char*)cache.cc_iovecs[i].iov_base > (char*)cache.cc_iovecs[i - 1].iov_base);
+    }
+
+    arena_config config = { .ac_cache = &cache };
+    arena ar;
+    arena_init(&ar, &config);
+    int index = -1;
+    char* first = (char*)arena_alloc_fixed(&ar, 1500, 16, &index, 0);
+    assert(first && index == 0 && first == cache.cc_iovecs[0].iov_base);
+    char* second = (char*)arena_alloc_fixed(&ar, 63 * 1024, 64, &index, 0);
+    assert(second && index == 1 && cache_buffer_index(&cache, second + 63 * 1024 - 1) == 1);
+
+    // Plain allocations land in the buffers too, and the set never grows
+    assert(arena_alloc(&ar, 60 * 1024, 8, SOFTFAIL));
+    assert(arena_alloc(&ar, 60 * 1024, 8, SOFTFAIL));
+    assert(!arena_alloc(&ar, 60 * 1024, 8, SOFTFAIL));
+    assert(!arena_alloc(&ar, 1024 * 1024, 8, SOFTFAIL));
+    assert(!cache.cc_head);
+    for (chunk* ch = ar.ar_head; ch; ch = ch->ch_next) assert(cache_buffer_index(&cache, ch->ch_data) >= 0);
+    assert(cache_buffer_index(&cache, &index) == -1);
+    assert(cache_buffer_index(&cache, ar.ar_head) == -1);
+
+    // One reset releases the whole batch, and the same buffers are reused
+    memset(first, 0xAB, 1500);
+    arena_reset(&ar);
+    unsigned char* again = (unsigned char*)arena_alloc_fixed(&ar, 1500, 16, &index, ZEROMEM);
+    assert((char*)again == first && index == 0 && again[1499] == 0);
+
+    // Freeing hands the buffers back without unmapping them
+    arena_free(&ar, 0);
+    int idle = 0;
+    for (chunk* ch = cache.cc_head; ch; ch = ch->ch_next) ++idle;
+    assert(idle == 4);
+    arena_init(&ar, &config);
+    assert(cache_buffer_index(&cache, arena_alloc(&ar, 16, 8, 0)) >= 0);
+    arena_free(&ar, 0);
+
+    // Arenas without registered buffers have no index to give
+    arena plain;
+    arena_init(&plain, 0);
+    assert(!arena_alloc_fixed(&plain, 16, 8, &index, 0));
+    arena_free(&plain, 0);
+    cache_free(&cache);
+    assert(!cache.cc_buffers && !cache.cc_head);
+}
+
+// Test savepoints within and across chunks
+void test_arena_rewind_basic() {
+    arena ar = {0};
+    arena_alloc(&ar, 100, 8, 0);
+    ptrdiff_t size = arena_get_size(&ar);
+
+    arena_savepoint mark = arena_mark(&ar);
+    char* scratch = (char*)arena_alloc(&ar, 64, 8, 0);
+    assert(scratch);
+    arena_rewind(&ar, mark);
+    assert(arena_get_size(&ar) == size);
+    assert((char*)arena_alloc(&ar, 64, 8, 0) == scratch);
+    arena_free(&ar, 0);
+}
+
+void test_arena_rewind_releases_chunks() {
+    chunk_cache cache = {0};
+    arena_config config = { .ac_cache = &cache };
+    arena ar;
+    arena_init(&ar, &config);
+    arena_alloc(&ar, 100, 8, 0);
+    chunk* tail = ar.ar_tail;
+
+    arena_savepoint outer = arena_mark(&ar);
+    arena_alloc(&ar, DEFAULT_CHUNK_SIZE, 8, 0);
+    arena_savepoint inner = arena_mark(&ar);
+    arena_alloc(&ar, 4 * DEFAULT_CHUNK_SIZE, 8, 0);
+    assert(ar.ar_tail != tail);
+
+    // Rewinding the inner mark only drops the chunk mapped after it
+    arena_rewind(&ar, inner);
+    assert(ar.ar_tail == inner.sp_tail && !ar.ar_tail->ch_next);
+    assert(cache.cc_head && !cache.cc_head->ch_next);
+
+    arena_rewind(&ar, outer);
+    assert(ar.ar_tail == tail && !tail->ch_next);
+    assert(ar.ar_curr == tail);
+    assert(arena_get_size(&ar) == 100 + 4); // rounded up to the alignment
+    arena_free(&ar, 0);
+    cache_free(&cache);
+}
+
+void test_arena_rewind_empty() {
+    arena ar = {0};
+    arena_savepoint mark = arena_mark(&ar);
+    assert(arena_alloc(&ar, 32, 8, 0));
+    arena_rewind(&ar, mark);
+    assert(!ar.ar_head && !ar.ar_tail && !ar.ar_curr);
+    assert(arena_get_size(&ar) == 0);
+    arena_free(&ar, 0);
+}
+
+// Test in-place growth of the latest allocation
+void test_arena_realloc_in_place() {
+    arena ar = {0};
+    int* vec = glad_new(&ar, int, 4);
+    for (int i = 0; i < 4; ++i) vec[i] = i;
+
+    int* grown = glad_realloc(&ar, int, vec, 4, 64);
+    assert(grown == vec);
+    for (int i = 0; i < 4; ++i) assert(grown[i] == i);
+    for (int i = 4; i < 64; ++i) assert(grown[i] == 0);
+    assert(arena_get_size(&ar) == 64 * sizeof(int));
+
+    // Shrinking the tail gives the bytes back to the arena
+    assert(arena_extend(&ar, grown, 64 * sizeof(int), 8 * sizeof(int), alignof(int), 0) == grown);
+    assert(arena_get_size(&ar) == 8 * sizeof(int));
+
+    // Growing again over the given-back bytes still zeroes them
+    grown[8] = 99;
+    grown = glad_realloc(&ar, int, grown, 8, 16);
+    assert(grown == vec && grown[8] == 0);
+    arena_free(&ar, 0);
+}
+
+void test_arena_realloc_copy() {
+    arena ar = {0};
+    char* first = (char*)arena_alloc(&ar, 16, 1, 0);
+    memcpy(first, "0123456789abcdef", 16);
+    assert(arena_alloc(&ar, 16, 1, 0)); // first is no longer the tail
+
+    assert(!arena_extend(&ar, first, 16, 32, 1, 0));
+    char* moved = (char*)arena_realloc(&ar, first, 16, 32, 1, ZEROMEM);
+    assert(moved && moved != first);
+    assert(memcmp(moved, "0123456789abcdef", 16) == 0);
+    for (int i = 16; i < 32; ++i) assert(moved[i] == 0);
+
+    // Shrinking a region that is not the tail keeps it where it is
+    assert(arena_realloc(&ar, first, 16, 8, 1, 0) == first);
+
+    // The current chunk is too small, so the region moves to a new one
+    char* big = (char*)arena_realloc(&ar, moved, 32, 2 * DEFAULT_CHUNK_SIZE, 1, 0);
+    assert(big && big != moved);
+    assert(memcmp(big, "0123456789abcdef", 16) == 0);
+    arena_free(&ar, 0);
+}
+
+// Freed nodes are reused by later requests of the same size class
+void test_pool_reuse() {
+    arena ar = {0};
+    arena_pool pool;
+    pool_init(&pool, &ar);
+
+    char* a = (char*)pool_alloc(&pool, 24, 8, 0);
+    char* b = (char*)pool_alloc(&pool, 100, 8, 0);
+    assert(a && b && ((uintptr_t)a % 32) == 0 && ((uintptr_t)b % 128) == 0);
+    memset(a, 0xAB, 24);
+    pool_free(&pool, a, 24, 8);
+
+    // same class, ZEROMEM still clears the recycled node
+    char* c = (char*)pool_alloc(&pool, 20, 4, ZEROMEM);
+    assert(c == a);
+    for (int i = 0; i < 20; ++i) assert(c[i] == 0);
+
+    // a different class does not take it
+    pool_free(&pool, c, 20, 4);
+    assert(pool_alloc(&pool, 64, 8, 0) != c);
+
+    // too large for the pool, served by the arena directly
+    assert(pool_class(8192, 8) == -1);
+    assert(pool_alloc(&pool, 8192, 8, 0));
+    pool_free(&pool, b, 100, 8);
+
+    pool_reset(&pool);
+    assert(pool_alloc(&pool, 24, 8, 0) != a);
+    arena_free(&ar, 0);
+}
+
+typedef struct pool_node {
+    struct pool_node* next;
+    long key;
+} pool_node;
+
+// Deleting and reinserting nodes does not grow the arena
+void test_pool_churn() {
+    arena ar = {0};
+    arena_pool pool;
+    pool_init(&pool, &ar);
+
+    pool_node* live[64] = {0};
+    for (int i = 0; i < 64; ++i) {
+        live[i] = glad_pool_new(&pool, pool_node);
+        assert(live[i] && live[i]->next == 0);
+    }
+    ptrdiff_t size = arena_get_size(&ar);
+    for (int round = 0; round < 10000; ++round) {
+        int i = round % 64;
+        glad_pool_delete(&pool, pool_node, live[i]);
+        live[i] = glad_pool_new(&pool, pool_node);
+        live[i]->key = round;
+    }
+    assert(arena_get_size(&ar) == size);
+    arena_free(&ar, 0);
+}
+
+// The tail vector grows in place, others move and keep their elements
+void test_vec_push() {
+    arena ar = {0};
+    arena_vec vec;
+    glad_vec_init(&vec, &ar, int);
+    for (int i = 0; i < 1000; ++i) {
+        *glad_vec_push(&vec, int) = i;
+    }
+    assert(vec.av_len == 1000 && vec.av_cap >= 1000);
+    char* first = vec.av_data;
+    // only the vector has been allocated, so it never had to move
+    assert(first == ar.ar_head->ch_data);
+
+    arena_alloc(&ar, 1, 1, 0);
+    int value = 1000;
+    while (vec.av_len < vec.av_cap) vec_push(&vec, &value);
+    vec_push(&vec, &value);
+    assert(vec.av_data != first);
+    for (int i = 0; i < 1000; ++i) assert(glad_vec_at(&vec, int, i) == i);
+    assert(glad_vec_at(&vec, int, vec.av_len - 1) == 1000);
+    arena_free(&ar, 0);
+}
+
+void test_str_builder() {
+    arena ar = {0};
+    arena_str str;
+    str_init(&str, &ar);
+    str_cat(&str, "hello");
+    str_push(&str, ", ", 2);
+    str_printf(&str, "%s #%d", "world", 42);
+    assert(str.av_len == 16);
+    assert(strcmp(str_cstr(&str), "hello, world #42") == 0);
+
+    // formatting past the spare capacity grows the string
+    for (int i = 0; i < 100; ++i) str_printf(&str, "%04d", i);
+    assert(str.av_len == 16 + 400);
+    assert(strncmp(str_cstr(&str) + 16, "000000010002", 12) == 0);
+    assert(strcmp(str.av_data + str.av_len - 4, "0099") == 0);
+    arena_free(&ar, 0);
+}
+
+void test_map_basic() {
+    arena ar = {0};
+    arena_map map;
+    glad_map_init(&map, &ar, long);
+    assert(!glad_map_get(&map, long, 1));
+
+    for (uint64_t k = 0; k < 5000; ++k) {
+        long* v = glad_map_put(&map, long, k * 7);
+        assert(v && *v == 0);
+        *v = (long)k;
+    }
+    assert(map.am_len == 5000 && map.am_has_zero);
+    for (uint64_t k = 0; k < 5000; ++k) {
+        assert(*glad_map_get(&map, long, k * 7) == (long)k);
+    }
+    assert(!map_get(&map, 3));
+    // an existing key keeps its value
+    assert(*glad_map_put(&map, long, 14) == 2);
+
+    // deleting every other key leaves the rest reachable
+    for (uint64_t k = 0; k < 5000; k += 2) {
+        assert(map_del(&map, k * 7));
+    }
+    assert(!map_del(&map, 0) && map.am_len == 2500);
+    for (uint64_t k = 0; k < 5000; ++k) {
+        long* v = glad_map_get(&map, long, k * 7);
+        assert(k % 2 ? v && *v == (long)k : !v);
+    }
+
+    ptrdiff_t iter = 0, seen = 0;
+    uint64_t key;
+    void* value;
+    while (map_next(&map, &iter, &key, &value)) {
+        assert(*(long*)value == (long)(key / 7));
+        ++seen;
+    }
+    assert(seen == 2500);
+    arena_free(&ar, 0);
+}
+
+// Test huge page chunks; both flags must fall back gracefully where huge pages are unavailable
+void test_alloc_chunk_hugepage() {
+    chunk* ch = alloc_chunk(1024, HUGEPAGE);
+    assert(ch);
+    assert(((uintptr_t)ch % GLAD_HUGE_PAGE_SIZE) == 0);
+    assert(CHUNK_ALLOC_SIZE(ch->ch_size) == GLAD_HUGE_PAGE_SIZE);
+    memset(ch->ch_data, 1, ch->ch_size);
+    free_chunk(ch);
+}
+
+void test_alloc_chunk_hugetlb_fallback() {
+    chunk* ch = alloc_chunk(GLAD_HUGE_PAGE_SIZE, HUGETLB | ZEROMEM);
+    assert(ch);
+    assert(CHUNK_ALLOC_SIZE(ch->ch_size) == 2 * GLAD_HUGE_PAGE_SIZE);
+    assert(ch->ch_data[ch->ch_size - 1] == 0);
+    free_chunk(ch);
+}
+
+void test_arena_hugepage_flags() {
+    chunk_cache cache = {0};
+    arena_config config = { .ac_flags = HUGEPAGE, .ac_cache = &cache };
+    arena ar;
+    arena_init(&ar, &config);
+    assert(arena_alloc(&ar, 64, 8, 0));
+    assert(CHUNK_ALLOC_SIZE(ar.ar_head->ch_size) % GLAD_HUGE_PAGE_SIZE == 0);
+    arena_free(&ar, 0);
+
+    // Cached huge page chunks are not handed to arenas that didn't ask for them
+    arena plain = {0};
+    plain.ar_cache = &cache;
+    assert(arena_alloc(&plain, 64, 8, 0));
+    assert(plain.ar_head->ch_size < GLAD_HUGE_PAGE_SIZE);
+    assert(cache.cc_head);
+    arena_free(&plain, 0);
+    cache_free(&cache);
+}
+
+// Test reserve-then-commit chunks
+void test_alloc_chunk_reserve() {
+    chunk* ch = alloc_chunk(1L << 30, RESERVE);
+    assert(ch);
+    assert(ch->ch_size >= 1L << 30);
+    assert(ch->ch_commit > 0 && ch->ch_commit < ch->ch_size);
+    memset(ch->ch_data, 1, ch->ch_commit);
+
+    assert(chunk_commit(ch, 3 * DEFAULT_COMMIT_SIZE + 1));
+    assert(ch->ch_commit > 3 * DEFAULT_COMMIT_SIZE);
+    assert(ch->ch_data[3 * DEFAULT_COMMIT_SIZE] == 0);
+    assert(!chunk_commit(ch, ch->ch_size + 1));
+    free_chunk(ch);
+}
+
+void test_arena_reserve_contiguous() {
+    arena_config config = { .ac_flags = RESERVE, .ac_reserve = 256L * 1024 * 1024 };
+    arena ar;
+    arena_init(&ar, &config);
+
+    // Every allocation lands right after the previous one, in a single chunk
+    char* first = (char*)arena_alloc(&ar, 1024, 8, 0);
+    char* prev = first;
+    for (int i = 1; i < 4096; ++i) {
+        char* next = (char*)arena_alloc(&ar, 1024, 8, ZEROMEM);
+        assert(next == prev + 1024);
+        prev = next;
+    }
+    assert(ar.ar_head == ar.ar_tail);
+    assert(ar.ar_head->ch_commit >= 4096 * 1024 && ar.ar_head->ch_commit < ar.ar_head->ch_size);
+
+    // Growing the tail commits more pages instead of moving it
+    assert(arena_realloc(&ar, prev, 1024, 8L * 1024 * 1024, 8, 0) == prev);
+
+    // Decommitting after a reset drops everything but the first step
+    memset(first, 0x5A, 4096);
+    arena_reset(&ar);
+    arena_decommit(&ar);
+    assert(ar.ar_head->ch_commit < DEFAULT_COMMIT_SIZE);
+    unsigned char* again = (unsigned char*)arena_alloc(&ar, 2L * 1024 * 1024, 8, ZEROMEM);
+    assert(again == (unsigned char*)first);
+    for (ptrdiff_t i = 0; i < 2L * 1024 * 1024; i += 512) assert(again[i] == 0);
+    arena_free(&ar, 0);
+}
+
+void test_arena_reserve_copy() {
+    arena_config config = { .ac_flags = RESERVE, .ac_reserve = 1L << 30 };
+    arena src, dst = {0};
+    arena_init(&src, &config);
+    int* data = glad_new(&src, int, 100000);
+    for (int i = 0; i < 100000; ++i) data[i] = i;
+
+    // The copy reserves the same address space but only commits what is used
+    arena_copy(&dst, &src, 0);
+    assert(dst.ar_head && dst.ar_head->ch_size == src.ar_head->ch_size);
+    assert(dst.ar_head->ch_commit < dst.ar_head->ch_size);
+    int* copied = (int*)dst.ar_head->ch_data;
+    for (int i = 0; i < 100000; ++i) assert(copied[i] == i);
+
+    // Coalescing a reserved chunk commits what it copies
+    int* coalesced = (int*)arena_crop_and_coalesce(&dst, 0);
+    assert(coalesced && coalesced[99999] == 99999);
+    arena_free(&src, 0);
+    arena_free(&dst, 0);
+}
+
+#ifdef GLAD_MEMFD
+void test_arena_snapshot_copy() {
+    arena_config config = { .ac_flags = SNAPSHOT, .ac_max_chunk = 1L << 20 };
+    arena src, dst = {0}, again = {0}, deep = {0};
+    arena_init(&src, &config);
+    int* blocks[4];
+    for (int b = 0; b < 4; ++b) {
+        blocks[b] = glad_new(&src, int, 200000);
+        for (int i = 0; i < 200000; ++i) blocks[b][i] = b * 200000 + i;
+    }
+    assert(src.ar_head != src.ar_tail);
+    assert(src.ar_head->ch_flags & CHUNK_MEMFD);
+
+    // The copy shares the pages and both source chunks stay where they were
+    arena_copy(&dst, &src, SNAPSHOT);
+    assert(arena_get_size(&dst) == arena_get_size(&src));
+    for (chunk* ch = src.ar_head; ch; ch = ch->ch_next) assert(ch->ch_flags & CHUNK_FROZEN);
+    for (chunk* ch = dst.ar_head; ch; ch = ch->ch_next) assert(ch->ch_flags & CHUNK_FROZEN);
+    int* copied = (int*)dst.ar_head->ch_data;
+    assert(copied != blocks[0]);
+    for (int i = 0; i < 200000; ++i) assert(copied[i] == i);
+
+    // Writes on either side stay on that side
+    blocks[0][7] = -1;
+    copied[9] = -2;
+    assert(copied[7] == 7 && blocks[0][9] == 9);
+
+    // Frozen chunks are copied with memcpy, and the copy sees the source's writes
+    arena_copy(&again, &src, SNAPSHOT);
+    copied = (int*)again.ar_head->ch_data;
+    assert(copied[7] == -1 && copied[9] == 9);
+    assert(!(again.ar_head->ch_flags & CHUNK_FROZEN));
+
+    // Without SNAPSHOT the copy is a deep copy of its own
+    arena_copy(&deep, &dst, 0);
+    copied = (int*)deep.ar_head->ch_data;
+    assert(copied[7] == 7 && copied[9] == -2);
+    assert(!(deep.ar_head->ch_flags & (CHUNK_FROZEN | CHUNK_MEMFD)));
+
+    arena_free(&src, 0);
+    arena_free(&dst, 0);
+    arena_free(&again, 0);
+    arena_free(&deep, 0);
+}
+
+void test_arena_snapshot_reserve() {
+    arena_config config = { .ac_flags = SNAPSHOT | RESERVE, .ac_reserve = 256L * 1024 * 1024 };
+    arena src, dst = {0};
+    arena_init(&src, &config);
+    char* first = (char*)arena_alloc(&src, 1L << 20, 8, 0);
+    memset(first, 0x11, 1L << 20);
+
+    arena_copy(&dst, &src, SNAPSHOT);
+    assert(dst.ar_head && dst.ar_head->ch_size == src.ar_head->ch_size);
+    assert(dst.ar_head->ch_flags & CHUNK_RESERVE);
+
+    // The source keeps committing in place after the snapshot
+    char* more = (char*)arena_alloc(&src, 8L * 1024 * 1024, 8, 0);
+    assert(more == first + (1L << 20));
+    memset(more, 0x22, 8L * 1024 * 1024);
+
+    // The copy only sees what was there at the time, and grows on its own
+    char* copied = (char*)dst.ar_head->ch_data;
+    for (ptrdiff_t i = 0; i < 1L << 20; i += 4096) assert(copied[i] == 0x11);
+    unsigned char* grown = (unsigned char*)arena_alloc(&dst, 8L * 1024 * 1024, 8, 0);
+    assert(grown == (unsigned char*)copied + (1L << 20));
+    for (ptrdiff_t i = 0; i < 8L * 1024 * 1024; i += 4096) assert(grown[i] == 0);
+    arena_free(&src, 0);
+    arena_free(&dst, 0);
+}
+#endif
+
+typedef struct image_node {
+    glad_rel next;
+    int value;
+} image_node;
+
+typedef struct image_root {
+    glad_rel list;
+    ptrdiff_t count;
+} image_root;
+
+// An image written by one arena is read back by the next, at whatever address it lands
+void test_arena_file_image() {
+    char path[] = "/tmp/glad_test_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd != -1);
+    close(fd);
+
+    arena ar;
+    arena_init(&ar, 0);
+    assert(arena_file_open(&ar, path, O_RDWR));
+    assert(!arena_get_root(&ar));
+    image_root* root = glad_new(&ar, image_root);
+    image_node* prev = 0;
+    for (int i = 0; i < 100000; ++i) {
+        image_node* node = glad_new(&ar, image_node);
+        glad_rel_set(&node->next, prev);
+        node->value = i;
+        prev = node;
+    }
+    glad_rel_set(&root->list, prev);
+    root->count = 100000;
+    arena_set_root(&ar, root);
+    assert(ar.ar_head == ar.ar_tail);
+    assert(arena_file_sync(&ar));
+    ptrdiff_t used = arena_get_size(&ar);
+    arena_free(&ar, 0);
+
+    // Read back in place, and keep allocating after the old contents
+    arena_init(&ar, 0);
+    assert(arena_file_open(&ar, path, O_RDWR));
+    assert(arena_get_size(&ar) == used);
+    root = (image_root*)arena_get_root(&ar);
+    assert(root && root->count == 100000);
+    int expect = 99999;
+    for (image_node* node = glad_rel_ptr(&root->list, image_node); node; node = glad_rel_ptr(&node->next, image_node))
+        assert(node->value == expect--);
+    assert(expect == -1);
+    int* more = glad_new(&ar, int);
+    assert((char*)more >= ar.ar_head->ch_data + used);
+    *more = 7;
+    ptrdiff_t more_offset = (char*)more - ar.ar_head->ch_data;
+    used = arena_get_size(&ar);
+    // ZEROMEM scrubs anonymous chunks only, the image is kept
+    arena_free(&ar, ZEROMEM);
+
+    // A read-only image is private: writes don't reach the file, and it can't grow
+    arena_init(&ar, 0);
+    assert(arena_file_open(&ar, path, O_RDONLY));
+    assert(arena_get_size(&ar) == used);
+    assert(*(int*)(ar.ar_head->ch_data + more_offset) == 7);
+    root = (image_root*)arena_get_root(&ar);
+    assert(root->count == 100000);
+    root->count = 1;
+    assert(!arena_alloc(&ar, 64L * 1024 * 1024, 8, SOFTFAIL));
+    arena_free(&ar, 0);
+    arena_init(&ar, 0);
+    assert(arena_file_open(&ar, path, O_RDONLY));
+    assert(((image_root*)arena_get_root(&ar))->count == 100000);
+    arena_free(&ar, 0);
+
+    // Anything else is refused
+    fd = open(path, O_WRONLY);
+    assert(pwrite(fd, "junk", 4, 0) == 4);
+    close(fd);
+    arena_init(&ar, 0);
+    assert(!arena_file_open(&ar, path, O_RDWR));
+    assert(errno == EINVAL && !ar.ar_head);
+    unlink(path);
+}
+
+// A file arena never grows past its reservation into anonymous chunks
+void test_arena_file_reserve() {
+    char path[] = "/tmp/glad_test_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd != -1);
+    close(fd);
+
+    arena_config config = { .ac_reserve = 4L * 1024 * 1024 };
+    arena ar;
+    arena_init(&ar, &config);
+    assert(arena_file_open(&ar, path, O_RDWR));
+    char* data = (char*)arena_alloc(&ar, 3L * 1024 * 1024, 8, 0);
+    assert(data);
+    memset(data, 0x3C, 3L * 1024 * 1024);
+    assert(!arena_alloc(&ar, 2L * 1024 * 1024, 8, SOFTFAIL));
+    assert(ar.ar_head == ar.ar_tail);
+    assert(!arena_crop_and_coalesce(&ar, 0));
+    arena_free(&ar, 0);
+
+    struct stat st;
+    assert(!stat(path, &st));
+    assert(st.st_size >= GLAD_IMAGE_OFFSET + 3L * 1024 * 1024 && st.st_size <= GLAD_IMAGE_OFFSET + 5L * 1024 * 1024);
+    unlink(path);
+}
+
+// Writes count bytes of a known pattern into a pipe from a child process
+pid_t stream_writer(int* read_end, ptrdiff_t count, ptrdiff_t piece) {
+    assert(piece <= 4096);
+    int fds[2];
+    assert(!pipe(fds));
+    pid_t pid = fork();
+    assert(pid != -1);
+    if (!pid) {
+        close(fds[0]);
+        char buffer[4096];
+        for (ptrdiff_t done = 0; done < count;) {
+            ptrdiff_t n = count - done < piece ? count - done : piece;
+            for (ptrdiff_t i = 0; i < n; ++i) buffer[i] = (char)('a' + (done + i) % 26);
+            if (write(fds[1], buffer, n) != n) _exit(1);
+            done += n;
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+    *read_end = fds[0];
+    return pid;
+}
+
+void test_arena_read_fd() {
+    arena ar;
+    arena_init(&ar, 0);
+
+    // A pipe has no size, so the region grows as data comes in
+    int fd;
+    pid_t pid = stream_writer(&fd, 300 * 1000, 1000);
+    ptrdiff_t size = 0;
+    char* data = (char*)arena_read_fd(&ar, fd, &size, 0);
+    assert(data && size == 300 * 1000 && data[size] == 0);
+    for (ptrdiff_t i = 0; i < size; ++i) assert(data[i] == 'a' + i % 26);
+    close(fd);
+    int status;
+    assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && !WEXITSTATUS(status));
+
+    // The region ends at the data, so the next allocation follows right behind it
+    char* next = (char*)arena_alloc(&ar, 1, 1, 0);
+    assert(next == data + size + 1);
+
+    // A regular file is read in one region of its size, from the current offset
+    char path[] = "/tmp/glad_test_XXXXXX";
+    fd = mkstemp(path);
+    assert(fd != -1 && write(fd, "hello, arena", 12) == 12);
+    assert(lseek(fd, 7, SEEK_SET) == 7);
+    data = (char*)arena_read_fd(&ar, fd, &size, 0);
+    assert(data && size == 5 && !strcmp(data, "arena"));
+    data = (char*)arena_read_fd(&ar, fd, &size, 0);
+    assert(data && size == 0 && data[0] == 0);
+    close(fd);
+    unlink(path);
+
+    assert(!arena_read_fd(&ar, -1, &size, 0) && size == -1 && errno == EINVAL);
+    arena_free(&ar, 0);
+}
+
+void test_arena_push_stream() {
+    arena ar;
+    arena_config config = { .ac_min_chunk = 64 * 1024 };
+    arena_init(&ar, &config);
+    int fd;
+    pid_t pid = stream_writer(&fd, 200 * 1000, 333);
+
+    // Each call returns what one read gave, laid out back to back within a chunk
+    char* data[1000];
+    ptrdiff_t sizes[1000];
+    int count = 0;
+    ptrdiff_t total = 0;
+    int contiguous = 0;
+    for (;;) {
+        assert(count < 1000);
+        data[count] = (char*)arena_push_stream(&ar, fd, 4096, &sizes[count], 0);
+        if (!data[count]) break;
+        assert(sizes[count] > 0 && sizes[count] <= 4096);
+        for (ptrdiff_t i = 0; i < sizes[count]; ++i) assert(data[count][i] == 'a' + (total + i) % 26);
+        contiguous += count > 0 && data[count] == data[count - 1] + sizes[count - 1];
+        total += sizes[count++];
+    }
+    assert(sizes[count] == 0 && total == 200 * 1000);
+    // the stream only breaks where it rolls into a new chunk
+    int chunks = 0;
+    for (chunk* ch = ar.ar_head; ch; ch = ch->ch_next) ++chunks;
+    assert(contiguous >= count - chunks);
+    close(fd);
+    int status;
+    assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && !WEXITSTATUS(status));
+
+    // Nothing stays allocated at end of file or on failure
+    assert(arena_get_size(&ar) == total);
+    ptrdiff_t size;
+    assert(!arena_push_stream(&ar, -1, 16, &size, 0) && size == -1);
+    assert(arena_get_size(&ar) == total);
+    arena_free(&ar, 0);
+}
+
+void test_arena_map_fd() {
+    char path[] = "/tmp/glad_test_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd != -1);
+    arena ar;
+    arena_init(&ar, 0);
+
+    // An empty file has nothing to map and is read instead
+    ptrdiff_t size = 0;
+    char* data = (char*)arena_map_fd(&ar, fd, &size, 0);
+    assert(data && size == 0 && data[0] == 0);
+
+    // Files that fill their last page still end in a 0
+    ptrdiff_t page = sysconf(_SC_PAGESIZE);
+    char* text = (char*)arena_alloc(&ar, 3 * page, 1, 0);
+    for (ptrdiff_t i = 0; i < 3 * page; ++i) text[i] = (char)('a' + i % 26);
+    assert(write(fd, text, 3 * page) == 3 * page);
+    int* before = glad_new(&ar, int);
+    data = (char*)arena_map_fd(&ar, fd, &size, 0);
+    assert(data && size == 3 * page && ((uintptr_t)data % page) == 0);
+    assert(!memcmp(data, text, size) && data[size] == 0);
+    assert(ar.ar_tail->ch_data == data);
+    assert(totals_match(&ar) && arena_contains(&ar, data + size));
+    // The chunk holds exactly the file and its 0, with no spare room
+    assert(ar.ar_tail->ch_size == size + 1 && ar.ar_tail->ch_offset == size + 1);
+
+    // The arena keeps allocating where it was
+    int* after = glad_new(&ar, int);
+    assert(after == before + 1);
+
+    // Writes stay in the arena's copy
+    data[0] = 'X';
+    char first;
+    assert(pread(fd, &first, 1, 0) == 1 && first == 'a');
+    arena_free(&ar, 0);
+
+    // A pipe is read instead
+    int pipe_fd;
+    pid_t pid = stream_writer(&pipe_fd, 5000, 1000);
+    arena_init(&ar, 0);
+    data = (char*)arena_map_fd(&ar, pipe_fd, &size, 0);
+    assert(data && size == 5000 && data[4999] == 'a' + 4999 % 26);
+    arena_free(&ar, 0);
+    close(pipe_fd);
+    waitpid(pid, 0, 0);
+    close(fd);
+    unlink(path);
+}
+
+#ifdef GLAD_NUMA
+// Chunks of an arena with ac_node prefer that node, cached and guarded ones included
+void test_arena_numa_bind() {
+    chunk_cache cache = {0};
+    arena ar;
+    arena_config config = { .ac_node = 1, .ac_min_chunk = 64 * 1024, .ac_cache = &cache };
+    assert(glad_node_count() >= 1);
+    assert(glad_current_node() >= 0 && glad_current_node() < glad_node_count());
+    // the second round gets the chunk the first one gave back to the cache
+    for (int round = 0; round < 3; ++round) {
+#ifdef GLAD_GUARD
+        config.ac_guard = round == 2;
+#else
+        if (round == 2) break;
+#endif
+        arena_init(&ar, &config);
+        char* block = (char*)arena_alloc(&ar, 256 * 1024, 8, ZEROMEM);
+        assert(block);
+        int mode = -1;
+        unsigned long mask[GLAD_MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+        // 2 is MPOL_F_ADDR, the policy of the range holding block
+        assert(!syscall(SYS_get_mempolicy, &mode, mask, GLAD_MAX_NODES + 1, block, 2));
+        assert(mode == GLAD_MPOL_PREFERRED && mask[0] == 1);
+        assert(round != 1 || cache.cc_head == 0);
+        arena_free(&ar, 0);
+        assert(round == 2 || cache.cc_head);
+    }
+    cache_free(&cache);
+
+    assert(glad_mbind(0, 4096, GLAD_MAX_NODES) == -1);
+}
+#endif
+
+#ifdef GLAD_STATS
+// Counters follow allocations, padding, resets and rewinds without walking the arena
+void test_arena_stats_basic() {
+    arena ar = {0};
+    arena_stats stats = arena_get_stats(&ar);
+    assert(stats.st_allocs == 0 && stats.st_chunks == 0);
+
+    arena_alloc(&ar, 3, 1, 0);
+    arena_alloc(&ar, 8, 8, 0);
+    stats = arena_get_stats(&ar);
+    assert(stats.st_allocs == 2);
+    assert(stats.st_requested == 11);
+    assert(stats.st_padding == 5);
+    assert(stats.st_used == 16 && stats.st_used == arena_get_size(&ar));
+    assert(stats.st_chunks == 1);
+    assert(stats.st_mapped == DEFAULT_CHUNK_SIZE);
+
+    arena_savepoint mark = arena_mark(&ar);
+    arena_alloc(&ar, DEFAULT_CHUNK_SIZE, 1, 0);
+    stats = arena_get_stats(&ar);
+    assert(stats.st_chunks == 2);
+    assert(stats.st_peak == 16 + DEFAULT_CHUNK_SIZE);
+
+    arena_rewind(&ar, mark);
+    stats = arena_get_stats(&ar);
+    assert(stats.st_used == 16 && stats.st_chunks == 1);
+    assert(stats.st_peak == 16 + DEFAULT_CHUNK_SIZE);
+
+    arena_reset(&ar);
+    assert(arena_get_stats(&ar).st_used == 0);
+    arena_free(&ar, 0);
+    stats = arena_get_stats(&ar);
+    assert(stats.st_chunks == 0 && stats.st_mapped == 0);
+    assert(stats.st_allocs == 3);
+}
+
+void test_arena_stats_failed() {
+    arena ar = {0};
+    assert(!arena_alloc(&ar, PTRDIFF_MAX / 2, 1, SOFTFAIL));
+    assert(arena_get_stats(&ar).st_failed == 1);
+    assert(arena_get_stats(&ar).st_allocs == 0);
+
+    // in-place growth is accounted as a resize, not an allocation
+    char* p = (char*)arena_alloc(&ar, 10, 1, 0);
+    assert(arena_extend(&ar, p, 10, 30, 1, 0) == p);
+    arena_stats stats = arena_get_stats(&ar);
+    assert(stats.st_allocs == 1 && stats.st_requested == 30 && stats.st_used == 30);
+
+    char line[256];
+    FILE* out = fmemopen(line, sizeof line, "w");
+    arena_stats_dump(&ar, out);
+    fclose(out);
+    assert(strstr(line, "allocs=1 failed=1 requested=30"));
+    arena_free(&ar, 0);
+}
+#endif
+
+#ifdef GLAD_DEBUG
+// The macros record file, line, type and tag, and the report aggregates them per site
+void test_arena_report_sites() {
+    arena ar = {0};
+    for (int i = 0; i < 3; ++i) {
+        glad_new(&ar, int, 4);
+    }
+    glad_tag(&ar, "parse");
+    int data[16] = {0};
+    int line = __LINE__ + 1;
+    glad_push(&ar, int, data, 16);
+    glad_tag(&ar, 0);
+
+    assert(ar.ar_site_count == 2);
+    assert(ar.ar_sites[0].as_count == 3 && ar.ar_sites[0].as_bytes == 3 * 4 * sizeof(int));
+    assert(!strcmp(ar.ar_sites[0].as_type, "int") && !ar.ar_sites[0].as_tag);
+    assert(ar.ar_sites[1].as_line == line && !strcmp(ar.ar_sites[1].as_tag, "parse"));
+
+    char report[512];
+    FILE* out = fmemopen(report, sizeof report, "w");
+    arena_report(&ar, out);
+    fclose(out);
+    // the larger site comes first
+    assert(strstr(report, "64 bytes") < strstr(report, "48 bytes"));
+    assert(strstr(report, "glad_test.c") && strstr(report, "int parse"));
+
+    arena_free(&ar, 0);
+    assert(!ar.ar_sites && ar.ar_site_count == 0);
+}
+#endif
+
+#ifdef GLAD_GUARD
+void guard_segv(int sig) {
+    (void)sig;
+    _exit(2);
+}
+
+// Writes to p in a child process and reports whether that faulted
+int write_faults(volatile char* p) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        signal(SIGSEGV, guard_segv);
+        signal(SIGBUS, guard_segv);
+        *p = 1;
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 2;
+}
+
+// Every chunk is followed by a PROT_NONE page
+void test_alloc_chunk_guard() {
+    ptrdiff_t page = sysconf(_SC_PAGESIZE);
+    chunk* ch = alloc_chunk(2 * page - sizeof(chunk), 0);
+    assert(ch && (ch->ch_flags & CHUNK_GUARD));
+    assert(!write_faults(&ch->ch_data[ch->ch_size - 1]));
+    assert(write_faults(&ch->ch_data[ch->ch_size]));
+    free_chunk(ch);
+}
+
+// ac_guard puts every allocation flush against a guard page of its own
+void test_arena_guard_each() {
+    ptrdiff_t page = sysconf(_SC_PAGESIZE);
+    arena ar;
+    arena_config config = { .ac_guard = 1 };
+    arena_init(&ar, &config);
+
+    char* p = (char*)arena_alloc(&ar, 100, 4, 0);
+    char* q = (char*)arena_alloc(&ar, 8, 8, ZEROMEM);
+    assert(p && q && ar.ar_head != ar.ar_tail);
+    assert(((uintptr_t)p + 100) % page == 0 && ((uintptr_t)q + 8) % page == 0);
+    assert(!write_faults(p + 99));
+    assert(write_faults(p + 100));
+
+    // growing copies into a new guarded allocation
+    char* r = glad_realloc(&ar, char, q, 8, 16);
+    assert(r && r != q && ((uintptr_t)r + 16) % page == 0);
+
+    // resetting unmaps the allocations, so stale pointers fault
+    arena_reset(&ar);
+    assert(!ar.ar_head && arena_get_size(&ar) == 0);
+    assert(write_faults(p));
+    assert(arena_alloc(&ar, 1, 1, 0));
+    arena_free(&ar, 0);
+}
+
+// Memory given back by reset and rewind is poisoned until it is handed out again
+void test_arena_reset_poison() {
+    arena ar = {0};
+    char* data = (char*)arena_alloc(&ar, 64, 8, 0);
+    memset(data, 0, 64);
+    arena_reset(&ar);
+#ifdef GLAD_ASAN
+    assert(__asan_address_is_poisoned(data) && __asan_address_is_poisoned(data + 63));
+    char* again = (char*)arena_alloc(&ar, 16, 8, 0);
+    assert(again == data && !__asan_address_is_poisoned(again + 15));
+    assert(__asan_address_is_poisoned(data + 16));
+#else
+    assert((unsigned char)data[0] == GLAD_POISON_BYTE && (unsigned char)data[63] == GLAD_POISON_BYTE);
+    arena_alloc(&ar, 16, 8, 0);
+#endif
+
+    arena_savepoint mark = arena_mark(&ar);
+    char* scratch = (char*)arena_alloc(&ar, 32, 8, ZEROMEM);
+    assert(scratch[31] == 0);
+    arena_rewind(&ar, mark);
+#ifdef GLAD_ASAN
+    assert(__asan_address_is_poisoned(scratch) && !__asan_address_is_poisoned(data));
+#else
+    assert((unsigned char)scratch[0] == GLAD_POISON_BYTE);
+#endif
+    arena_free(&ar, 0);
+}
+#endif
+
+#ifdef GLAD_THREADS
+// Test concurrent allocation: every thread tags its blocks, then checks no one overwrote them
+#define CARENA_THREADS 4
+#define CARENA_ALLOCS 20000
+
+typedef struct {
+    carena* ca;
+    unsigned char tag;
+    unsigned char* blocks[CARENA_ALLOCS];
+} carena_worker;
+
+void* carena_worker_run(void* arg) {
+    carena_worker* w = (carena_worker*)arg;
+    for (int i = 0; i < CARENA_ALLOCS; ++i) {
+        ptrdiff_t alignment = (ptrdiff_t)1 << (i % 8); // 1..128
+        ptrdiff_t size = 1 + (i * 7) % 200;
+        unsigned char* block = (unsigned char*)carena_alloc(w->ca, size, alignment, ZEROMEM);
+        assert(block);
+        assert(((uintptr_t)block % alignment) == 0);
+        for (ptrdiff_t j = 0; j < size; ++j) {
+            assert(block[j] == 0);
+        }
+        memset(block, w->tag, size);
+        w->blocks[i] = block;
+    }
+    return 0;
+}
+
+void test_carena_alloc_threads() {
+    carena ca;
+    arena_config config = { .ac_min_chunk = 16 * 1024 }; // force plenty of chunk switches
+    assert(carena_init(&ca, &config) == 0);
+
+    static carena_worker workers[CARENA_THREADS];
+    pthread_t threads[CARENA_THREADS];
+    for (int t = 0; t < CARENA_THREADS; ++t) {
+        workers[t].ca = &ca;
+        workers[t].tag = (unsigned char)(t + 1);
+        assert(pthread_create(&threads[t], 0, carena_worker_run, &workers[t]) == 0);
+    }
+    for (int t = 0; t < CARENA_THREADS; ++t) {
+        pthread_join(threads[t], 0);
+    }
+
+    for (int t = 0; t < CARENA_THREADS; ++t) {
+        for (int i = 0; i < CARENA_ALLOCS; ++i) {
+            ptrdiff_t size = 1 + (i * 7) % 200;
+            for (ptrdiff_t j = 0; j < size; ++j) {
+                assert(workers[t].blocks[i][j] == workers[t].tag);
+            }
+        }
+    }
+    assert(carena_get_size(&ca) > 0);
+
+    // After a reset, the first chunk is reused
+    chunk* head = ca.ca_arena.ar_head;
+    carena_reset(&ca);
+    unsigned char* again = (unsigned char*)carena_alloc(&ca, 16, 16, ZEROMEM);
+    assert(again >= (unsigned char*)head->ch_data && again < (unsigned char*)head->ch_data + head->ch_size);
+    assert(again[0] == 0);
+    carena_free(&ca, 0);
+}
+
+void test_carena_reserve() {
+    carena ca;
+    arena_config config = { .ac_flags = RESERVE, .ac_reserve = 64L * 1024 * 1024 };
+    assert(carena_init(&ca, &config) == 0);
+    for (int i = 0; i < 1024; ++i) {
+        char* block = (char*)carena_alloc(&ca, 1024, 64, ZEROMEM);
+        assert(block && ((uintptr_t)block % 64) == 0);
+        memset(block, 1, 1024);
+    }
+    // The reservation is committed step by step instead of mapping new chunks
+    assert(ca.ca_arena.ar_head == ca.ca_arena.ar_tail);
+    assert(carena_get_size(&ca) >= 1024 * 1024);
+    carena_free(&ca, 0);
+}
+
+// Test the per-node set, one carena for each possible node
+void test_carena_nodes() {
+    carena_nodes set;
+    arena_config config = { .ac_flags = ZEROMEM };
+    assert(carena_nodes_init(&set, &config) == 0);
+    assert(set.cn_count == glad_node_count() && set.cn_count >= 1);
+    carena* local = carena_nodes_local(&set);
+    assert(local >= set.cn_arenas && local < set.cn_arenas + set.cn_count);
+    for (int i = 0; i < set.cn_count; ++i) {
+        assert(set.cn_arenas[i].ca_arena.ar_flags & ZEROMEM);
+#ifdef GLAD_NUMA
+        assert(set.cn_arenas[i].ca_arena.ar_node == i + 1);
+#endif
+    }
+    int* block = (int*)carena_alloc(local, 100 * sizeof(int), 16, 0);
+    assert(block && block[99] == 0);
+    carena_nodes_free(&set, 0);
+    assert(!set.cn_arenas && set.cn_count == 0);
+}
+
+// Test thread arenas layered on a shared carena
+static carena tarena_parent;
+static _Thread_local tarena local = { .ta_parent = &tarena_parent, .ta_slab = 8 * 1024 };
+
+void* tarena_worker_run(void* arg) {
+    unsigned char tag = (unsigned char)(uintptr_t)arg;
+    unsigned char* blocks[1000];
+    int contiguous = 0;
+    for (int i = 0; i < 1000; ++i) {
+        blocks[i] = (unsigned char*)tarena_alloc(&local, 48, 16, ZEROMEM);
+        assert(blocks[i] && ((uintptr_t)blocks[i] % 16) == 0);
+        for (int j = 0; j < 48; ++j) assert(blocks[i][j] == 0);
+        memset(blocks[i], tag, 48);
+        contiguous += i > 0 && blocks[i] == blocks[i - 1] + 48;
+    }
+    // consecutive small allocations come from the same slab, whatever the other threads do
+    assert(contiguous >= 999 - (1000 * 48 / (8 * 1024) + 1));
+    // large allocations bypass the slab
+    assert(tarena_alloc(&local, 8 * 1024, 8, 0));
+    for (int i = 0; i < 1000; ++i) {
+        for (int j = 0; j < 48; ++j) assert(blocks[i][j] == tag);
+    }
+    return 0;
+}
+
+void test_tarena_alloc_threads() {
+    assert(carena_init(&tarena_parent, 0) == 0);
+    pthread_t threads[CARENA_THREADS];
+    for (int t = 0; t < CARENA_THREADS; ++t) {
+        assert(pthread_create(&threads[t], 0, tarena_worker_run, (void*)(uintptr_t)(t + 1)) == 0);
+    }
+    for (int t = 0; t < CARENA_THREADS; ++t) {
+        pthread_join(threads[t], 0);
+    }
+
+    // The main thread's slab is dropped when the parent is reset
+    char* first = (char*)tarena_alloc(&local, 32, 8, 0);
+    char* second = (char*)tarena_alloc(&local, 32, 8, 0);
+    assert(second == first + 32);
+    memset(first, 0xEE, 64);
+    carena_reset(&tarena_parent);
+    unsigned char* after = (unsigned char*)tarena_alloc(&local, 32, 8, ZEROMEM);
+    assert(after && after != (unsigned char*)second + 32);
+    for (int j = 0; j < 32; ++j) assert(after[j] == 0);
+    carena_free(&tarena_parent, 0);
+}
+#endif
 
 // Main function to run all tests
 int main() {
@@ -311,6 +2039,8 @@ int main() {
     run_test("test_arena_get_size_empty", test_arena_get_size_empty);
     run_test("test_arena_get_size_partial", test_arena_get_size_partial);
     run_test("test_arena_get_size_multiple_chunks", test_arena_get_size_multiple_chunks);
+    run_test("test_arena_get_size_running", test_arena_get_size_running);
+    run_test("test_arena_contains", test_arena_contains);
 
     run_test("test_arena_push_basic", test_arena_push_basic);
     run_test("test_arena_push_null_data", test_arena_push_null_data);
@@ -319,11 +2049,21 @@ int main() {
     run_test("test_arena_crop_and_coalesce_empty", test_arena_crop_and_coalesce_empty);
     run_test("test_arena_crop_and_coalesce_basic", test_arena_crop_and_coalesce_basic);
     run_test("test_arena_crop_and_coalesce_large", test_arena_crop_and_coalesce_large);
+    run_test("test_arena_compact_relocs", test_arena_compact_relocs);
+    run_test("test_arena_copy_parallel", test_arena_copy_parallel);
+    run_test("test_arena_compact_parallel", test_arena_compact_parallel);
+    run_test("test_arena_finalizers", test_arena_finalizers);
+    run_test("test_arena_finalizers_compact", test_arena_finalizers_compact);
+
+    run_test("test_arena_alloc_batch", test_arena_alloc_batch);
+    run_test("test_glad_new_n", test_glad_new_n);
 
     run_test("test_arena_copy_basic", test_arena_copy_basic);
     run_test("test_arena_copy_empty", test_arena_copy_empty);
 
     run_test("test_arena_clear", test_arena_clear);
+    run_test("test_arena_clear_used_prefix", test_arena_clear_used_prefix);
+    run_test("test_arena_clear_discard", test_arena_clear_discard);
     run_test("test_arena_reset", test_arena_reset);
 
     run_test("test_arena_free_basic", test_arena_free_basic);
@@ -336,6 +2076,81 @@ int main() {
     run_test("test_arena_alloc_alignment_edge_cases", test_arena_alloc_alignment_edge_cases);
     run_test("test_arena_alloc_alignment_fallback_chunk_allocation", test_arena_alloc_alignment_fallback_chunk_allocation);
 
+    run_test("test_arena_alloc_bump_contiguous", test_arena_alloc_bump_contiguous);
+    run_test("test_arena_alloc_reset_reuses_chunks", test_arena_alloc_reset_reuses_chunks);
+    run_test("test_arena_alloc_firstfit", test_arena_alloc_firstfit);
+
+    run_test("test_arena_growth_default", test_arena_growth_default);
+    run_test("test_arena_growth_geometric", test_arena_growth_geometric);
+
+    run_test("test_arena_alloc_zeromem_fresh", test_arena_alloc_zeromem_fresh);
+    run_test("test_arena_alloc_zeromem_after_reset", test_arena_alloc_zeromem_after_reset);
+
+    run_test("test_glad_copy", test_glad_copy);
+    run_test("test_chunk_cache_reuse", test_chunk_cache_reuse);
+    run_test("test_chunk_cache_high_water", test_chunk_cache_high_water);
+    run_test("test_cache_buffers", test_cache_buffers);
+
+    run_test("test_arena_rewind_basic", test_arena_rewind_basic);
+    run_test("test_arena_rewind_releases_chunks", test_arena_rewind_releases_chunks);
+    run_test("test_arena_rewind_empty", test_arena_rewind_empty);
+
+    run_test("test_arena_realloc_in_place", test_arena_realloc_in_place);
+    run_test("test_arena_realloc_copy", test_arena_realloc_copy);
+
+    run_test("test_pool_reuse", test_pool_reuse);
+    run_test("test_pool_churn", test_pool_churn);
+
+    run_test("test_vec_push", test_vec_push);
+    run_test("test_str_builder", test_str_builder);
+    run_test("test_map_basic", test_map_basic);
+
+    run_test("test_alloc_chunk_hugepage", test_alloc_chunk_hugepage);
+    run_test("test_alloc_chunk_hugetlb_fallback", test_alloc_chunk_hugetlb_fallback);
+    run_test("test_arena_hugepage_flags", test_arena_hugepage_flags);
+
+    run_test("test_alloc_chunk_reserve", test_alloc_chunk_reserve);
+    run_test("test_arena_reserve_contiguous", test_arena_reserve_contiguous);
+    run_test("test_arena_reserve_copy", test_arena_reserve_copy);
+
+#ifdef GLAD_MEMFD
+    run_test("test_arena_snapshot_copy", test_arena_snapshot_copy);
+    run_test("test_arena_snapshot_reserve", test_arena_snapshot_reserve);
+#endif
+
+    run_test("test_arena_file_image", test_arena_file_image);
+    run_test("test_arena_file_reserve", test_arena_file_reserve);
+
+    run_test("test_arena_read_fd", test_arena_read_fd);
+    run_test("test_arena_push_stream", test_arena_push_stream);
+    run_test("test_arena_map_fd", test_arena_map_fd);
+
+#ifdef GLAD_NUMA
+    run_test("test_arena_numa_bind", test_arena_numa_bind);
+#endif
+
+#ifdef GLAD_STATS
+    run_test("test_arena_stats_basic", test_arena_stats_basic);
+    run_test("test_arena_stats_failed", test_arena_stats_failed);
+#endif
+
+#ifdef GLAD_DEBUG
+    run_test("test_arena_report_sites", test_arena_report_sites);
+#endif
+
+#ifdef GLAD_GUARD
+    run_test("test_alloc_chunk_guard", test_alloc_chunk_guard);
+    run_test("test_arena_guard_each", test_arena_guard_each);
+    run_test("test_arena_reset_poison", test_arena_reset_poison);
+#endif
+
+#ifdef GLAD_THREADS
+    run_test("test_carena_alloc_threads", test_carena_alloc_threads);
+    run_test("test_carena_reserve", test_carena_reserve);
+    run_test("test_carena_nodes", test_carena_nodes);
+    run_test("test_tarena_alloc_threads", test_tarena_alloc_threads);
+#endif
+
     printf("All tests passed.\n");
     return 0;
 }
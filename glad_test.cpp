@@ -0,0 +1,152 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "glad.hpp"
+
+// Helper function for running individual tests
+void run_test(const char* test_name, void (*test_func)()) {
+    printf("Running %s...\n", test_name);
+    test_func();
+    printf("%s passed.\n", test_name);
+}
+
+// True if ptr lies in one of the arena's chunks
+bool in_arena(::arena* ar, const void* ptr) {
+    arena_sync(ar);
+    for (chunk* ch = ar->ar_head; ch; ch = ch->ch_next) {
+        uintptr_t start = (uintptr_t)ch->ch_data;
+        if ((uintptr_t)ptr >= start && (uintptr_t)ptr < start + ch->ch_offset)
+            return true;
+    }
+    return false;
+}
+
+// Test the owning arena with allocation and moves
+void test_arena_alloc_typed() {
+    glad::arena ar;
+    int* data = ar.alloc<int>(1000);
+    for (int i = 0; i < 1000; ++i) assert(data[i] == 0);
+    double* aligned = ar.alloc<double>();
+    assert((uintptr_t)aligned % alignof(double) == 0);
+    void* page = ar.allocate(100, 4096);
+    assert((uintptr_t)page % 4096 == 0);
+    assert(ar.size() >= 1000 * sizeof(int) + sizeof(double) + 100);
+}
+
+void test_arena_move() {
+    glad::arena a;
+    int* data = a.alloc<int>(10);
+    data[3] = 3;
+
+    glad::arena b(std::move(a));
+    assert(!a.get()->ar_head && a.size() == 0);
+    assert(in_arena(b.get(), data) && data[3] == 3);
+
+    glad::arena c;
+    c.alloc<char>(100);
+    c = std::move(b);
+    assert(!b.get()->ar_head);
+    assert(in_arena(c.get(), data) && data[3] == 3);
+
+    // The moved-from arena is empty but still usable
+    assert(a.alloc<int>());
+}
+
+void test_arena_alloc_failure() {
+    glad::arena ar;
+    bool thrown = false;
+    try {
+        ar.allocate(PTRDIFF_MAX / 2);
+    } catch (const std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+// Test make with trivial and non-trivial types
+struct tracked {
+    std::vector<int>* log;
+    int id;
+    tracked(std::vector<int>* l, int i) : log(l), id(i) {}
+    ~tracked() { log->push_back(id); }
+};
+
+struct point {
+    int x, y;
+};
+
+void test_arena_make_destructors() {
+    std::vector<int> log;
+    {
+        glad::arena ar;
+        point* p = ar.make<point>(point{1, 2});
+        assert(p->x == 1 && p->y == 2);
+        for (int i = 0; i < 3; ++i) ar.make<tracked>(&log, i);
+
+        // Destructors run last first, on reset and on destruction
+        ar.reset();
+        assert((log == std::vector<int>{2, 1, 0}));
+        tracked* t = ar.make<tracked>(&log, 7);
+        assert(t->id == 7);
+        ar.make<std::string>(200, 'x');
+    }
+    assert((log == std::vector<int>{2, 1, 0, 7}));
+}
+
+// Test standard containers on top of the arena
+void test_pmr_containers() {
+    glad::arena ar;
+    glad::memory_resource resource(ar);
+    std::pmr::vector<int> vec(&resource);
+    for (int i = 0; i < 10000; ++i) vec.push_back(i);
+    assert(in_arena(ar.get(), vec.data()));
+    for (int i = 0; i < 10000; ++i) assert(vec[i] == i);
+
+    std::pmr::unordered_map<int, std::pmr::string> map(&resource);
+    for (int i = 0; i < 1000; ++i) map.emplace(i, std::pmr::string(50, 'a' + i % 26));
+    assert(map.size() == 1000 && map[25][0] == 'z');
+    assert(in_arena(ar.get(), map[999].data()));
+
+    // Resources compare equal when they share an arena
+    glad::memory_resource same(ar);
+    glad::arena second;
+    glad::memory_resource other(second);
+    assert(resource.is_equal(resource) && resource.is_equal(same));
+    assert(!resource.is_equal(other) && !resource.is_equal(*std::pmr::new_delete_resource()));
+}
+
+void test_stl_allocator() {
+    glad::arena ar;
+    std::vector<int, glad::allocator<int>> vec(ar);
+    for (int i = 0; i < 10000; ++i) vec.push_back(i);
+    assert(in_arena(ar.get(), vec.data()));
+
+    using pair_alloc = glad::allocator<std::pair<const int, long>>;
+    std::unordered_map<int, long, std::hash<int>, std::equal_to<int>, pair_alloc> map(16, std::hash<int>(), std::equal_to<int>(), pair_alloc(ar));
+    for (int i = 0; i < 1000; ++i) map[i] = i * 2L;
+    assert(map.size() == 1000 && map[500] == 1000);
+
+    // Rebound copies allocate from the same arena and compare equal
+    glad::allocator<char> rebound(vec.get_allocator());
+    assert(rebound == vec.get_allocator());
+    glad::arena other;
+    assert(glad::allocator<int>(other) != vec.get_allocator());
+}
+
+int main() {
+    run_test("test_arena_alloc_typed", test_arena_alloc_typed);
+    run_test("test_arena_move", test_arena_move);
+    run_test("test_arena_alloc_failure", test_arena_alloc_failure);
+
+    run_test("test_arena_make_destructors", test_arena_make_destructors);
+
+    run_test("test_pmr_containers", test_pmr_containers);
+    run_test("test_stl_allocator", test_stl_allocator);
+
+    printf("All tests passed.\n");
+    return 0;
+}